@@ -0,0 +1,567 @@
+// Headless world-generation benchmark: generates and meshes an N x N chunk
+// region for a fixed seed without opening a window or touching OpenGL.
+//
+//   worldgen_bench [--seed N] [--size N] [--runs N] [--threads 1,2,4,...]
+//
+// Determinism check against stored golden hashes of block data and meshes:
+//
+//   worldgen_bench --write-goldens bench/goldens.txt
+//   worldgen_bench --verify bench/goldens.txt [--threads 1,2,4,...]
+//
+// Vertex arena allocator churn (chunk meshes streaming in and out as the player moves):
+//
+//   worldgen_bench --arena [--size N]
+//
+// Vertex counts and meshing time per LOD scale (whole region meshed at 1x, 2x, 4x, 8x):
+//
+//   worldgen_bench --lod [--size N]
+//
+// Chunk codec compression ratio and encode/decode throughput against a plain copy:
+//
+//   worldgen_bench --codec [--size N] [--runs N]
+//
+// Streaming through updateChunks (radius 6, 400 chunk-border crossings) with the worker pool
+// meshing while chunks unload and are reused from the chunk pool:
+//
+//   worldgen_bench --stream [--seed N]
+
+#include "world.h"
+#include "chunk.h"
+#include "world_hash.h"
+#include "visibility.h"
+#include "vertex_arena.h"
+#include "lod.h"
+#include "chunk_codec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    unsigned int seed = 1337;
+    int size = 16;
+    int runs = 3;
+    std::vector<int> threadCounts;
+    std::string writeGoldens;
+    std::string verifyGoldens;
+    bool arena = false;
+    bool lod = false;
+    bool codec = false;
+    bool stream = false;
+};
+
+// Fixed golden set: these seeds, each over a GOLDEN_SIZE x GOLDEN_SIZE region.
+static const unsigned int GOLDEN_SEEDS[] = { 0, 1337, 987654321 };
+static const int GOLDEN_SIZE = 6;
+
+struct StageTimes {
+    std::vector<double> perChunkMs;
+    double wallMs = 0.0;
+};
+
+struct RunResult {
+    StageTimes terrain;
+    StageTimes trees;
+    StageTimes mesh;
+    size_t chunkCount = 0;
+    size_t vertexCount = 0;
+    size_t blockBytes = 0;
+    size_t meshBytes = 0;
+};
+
+static double elapsedMs(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t idx = (size_t)(p * (v.size() - 1) + 0.5);
+    return v[std::min(idx, v.size() - 1)];
+}
+
+// Runs job(i) for i in [0, count) on `threads` workers and records per-item times.
+static void runParallel(int threads, size_t count, StageTimes& out,
+                        const std::function<void(size_t)>& job) {
+    out.perChunkMs.assign(count, 0.0);
+    std::atomic<size_t> next{0};
+
+    auto worker = [&]() {
+        while (true) {
+            size_t i = next.fetch_add(1);
+            if (i >= count) break;
+            auto t0 = Clock::now();
+            job(i);
+            out.perChunkMs[i] = elapsedMs(t0, Clock::now());
+        }
+    };
+
+    auto start = Clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    out.wallMs = elapsedMs(start, Clock::now());
+}
+
+struct Region {
+    ChunkManager manager;
+    std::vector<ManagedChunk*> chunks;
+    std::vector<std::vector<float>> meshes;
+};
+
+static void buildRegion(Region& region, unsigned int seed, int size, int threads, RunResult& r) {
+    initPerlin(seed);
+
+    int half = size / 2;
+    for (int cz = -half; cz < size - half; cz++) {
+        for (int cx = -half; cx < size - half; cx++) {
+            ManagedChunk* mc = new ManagedChunk(cx, cz);
+            region.manager.addChunk(cx, cz, mc);
+            region.chunks.push_back(mc);
+        }
+    }
+    auto& chunks = region.chunks;
+    r.chunkCount = chunks.size();
+
+    runParallel(threads, chunks.size(), r.terrain, [&](size_t i) {
+        generateTerrainForChunk(chunks[i]->chunk);
+    });
+    for (auto* mc : chunks) mc->terrainGenerated = true;
+
+    // Trees mutate neighbouring chunks, so they run on one thread like updateChunks does.
+    r.trees.perChunkMs.assign(chunks.size(), 0.0);
+    auto treesStart = Clock::now();
+    for (size_t i = 0; i < chunks.size(); i++) {
+        auto t0 = Clock::now();
+        generateTrees(chunks[i]->chunk, &region.manager);
+        chunks[i]->structuresGenerated = true;
+        r.trees.perChunkMs[i] = elapsedMs(t0, Clock::now());
+    }
+    r.trees.wallMs = elapsedMs(treesStart, Clock::now());
+
+    region.meshes.assign(chunks.size(), {});
+    runParallel(threads, chunks.size(), r.mesh, [&](size_t i) {
+        ChunkMesh& mesh = chunks[i]->mesh;
+        ChunkBorders borders;
+        borders.copyFrom(region.manager, chunks[i]->chunk.chunkX, chunks[i]->chunk.chunkZ, 1, nullptr);
+        region.meshes[i] = ChunkMesh::buildVertices(chunks[i]->chunk, borders, &mesh.sectionStarts, nullptr,
+                                                    &mesh.cutoutVertices, &mesh.cutoutSectionStarts);
+        // Hashes and counts cover both passes: opaque vertices, then the cutout (leaves) ones.
+        region.meshes[i].insert(region.meshes[i].end(), mesh.cutoutVertices.begin(), mesh.cutoutVertices.end());
+        computeSectionConnectivity(chunks[i]->chunk, mesh.sectionConnectivity);
+    });
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        r.vertexCount += region.meshes[i].size() / ChunkMesh::floatsPerVertex;
+        r.meshBytes += region.meshes[i].size() * sizeof(float);
+        r.blockBytes += chunks[i]->chunk.blocks.size() * sizeof(Block);
+    }
+}
+
+static RunResult runOnce(const BenchOptions& opt, int threads) {
+    RunResult r;
+    Region region;
+    buildRegion(region, opt.seed, opt.size, threads, r);
+    return r;
+}
+
+// One line per chunk: seed cx cz blockHash meshHash
+static std::vector<std::string> goldenLines(int threads) {
+    std::vector<std::string> lines;
+    for (unsigned int seed : GOLDEN_SEEDS) {
+        RunResult r;
+        Region region;
+        buildRegion(region, seed, GOLDEN_SIZE, threads, r);
+        for (size_t i = 0; i < region.chunks.size(); i++) {
+            Chunk& c = region.chunks[i]->chunk;
+            char line[128];
+            std::snprintf(line, sizeof(line), "%u %d %d %016llx %016llx", seed, c.chunkX, c.chunkZ,
+                          (unsigned long long)hashChunkBlocks(c),
+                          (unsigned long long)hashMeshVertices(region.meshes[i], ChunkMesh::floatsPerVertex));
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+static int writeGoldens(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::printf("cannot write %s\n", path.c_str());
+        return 1;
+    }
+    auto lines = goldenLines(1);
+    out << "# seed chunkX chunkZ blockHash meshHash\n";
+    for (auto& l : lines) out << l << "\n";
+    std::printf("wrote %zu golden chunk hashes to %s\n", lines.size(), path.c_str());
+    return 0;
+}
+
+static int verifyGoldens(const std::string& path, const std::vector<int>& threadCounts) {
+    std::ifstream in(path);
+    if (!in) {
+        std::printf("cannot read %s\n", path.c_str());
+        return 1;
+    }
+    std::vector<std::string> expected;
+    for (std::string l; std::getline(in, l);) {
+        if (!l.empty() && l[0] != '#') expected.push_back(l);
+    }
+
+    int failures = 0;
+    for (int threads : threadCounts) {
+        auto actual = goldenLines(threads);
+        int mismatched = 0;
+        for (size_t i = 0; i < std::max(actual.size(), expected.size()); i++) {
+            const std::string a = i < actual.size() ? actual[i] : "<missing>";
+            const std::string e = i < expected.size() ? expected[i] : "<missing>";
+            if (a != e) {
+                if (mismatched < 10) std::printf("  mismatch: expected '%s' got '%s'\n", e.c_str(), a.c_str());
+                mismatched++;
+            }
+        }
+        std::printf("threads %d: %s (%d of %zu chunks differ)\n", threads,
+                    mismatched ? "FAIL" : "ok", mismatched, expected.size());
+        failures += mismatched;
+    }
+    return failures ? 1 : 0;
+}
+
+static void printArenaStats(const char* label, const ArenaStats& a) {
+    std::printf("  %-10s capacity %9u used %9u (%5.1f%%) | free blocks %5u largest %9u | fragmentation %.3f\n",
+                label, a.capacity, a.used, a.capacity ? 100.0 * a.used / a.capacity : 0.0,
+                a.freeBlocks, a.largestFree, a.fragmentation());
+}
+
+// Streams a size x size window of chunk meshes across the world through VertexArenaAllocator,
+// with mesh sizes taken from real generated chunks, and occasional remeshes of live chunks.
+static int runArenaSim(const BenchOptions& opt) {
+    RunResult r;
+    Region region;
+    buildRegion(region, opt.seed, opt.size, 1, r);
+    std::vector<uint32_t> sizes;
+    for (auto& m : region.meshes) sizes.push_back((uint32_t)(m.size() / ChunkMesh::floatsPerVertex));
+
+    auto sizeFor = [&](int cx, int cz, int generation) {
+        uint32_t h = (uint32_t)(cx * 73856093) ^ (uint32_t)(cz * 19349663) ^ (uint32_t)(generation * 83492791);
+        uint32_t base = sizes[h % sizes.size()];
+        return base - base / 10 + (h >> 8) % (base / 5 + 1); // +-10%
+    };
+
+    const int w = opt.size;
+    uint32_t capacity = 1;
+    while (capacity < sizes.size() * 8192u) capacity *= 2;
+    VertexArenaAllocator arena(capacity);
+
+    std::unordered_map<std::pair<int,int>, ArenaRange, pair_hash> live;
+    int grows = 0;
+    size_t ops = 0;
+    auto alloc = [&](ArenaRange& range, uint32_t count) {
+        ops++;
+        if (!arena.allocate(count, range)) {
+            arena.grow(arena.capacity() * 2);
+            grows++;
+            arena.allocate(count, range);
+        }
+    };
+
+    auto start = Clock::now();
+    for (int z = 0; z < w; z++)
+        for (int x = 0; x < w; x++) alloc(live[{x, z}], sizeFor(x, z, 0));
+    printArenaStats("initial", arena.stats());
+
+    const int steps = w * 8;
+    for (int step = 1; step <= steps; step++) {
+        // Window slides one chunk in +x: drop the trailing column, load the leading one.
+        for (int z = 0; z < w; z++) {
+            auto it = live.find({step - 1, z});
+            arena.free(it->second);
+            ops++;
+            live.erase(it);
+            alloc(live[{step - 1 + w, z}], sizeFor(step - 1 + w, z, 0));
+        }
+        // A few live chunks get remeshed (block edits, late neighbours).
+        for (int k = 0; k < w / 2 + 1; k++) {
+            int x = step + (int)((step * 7 + k * 13) % w);
+            int z = (step * 5 + k * 11) % w;
+            auto it = live.find({x, z});
+            if (it == live.end()) continue;
+            arena.free(it->second);
+            ops++;
+            alloc(it->second, sizeFor(x, z, step));
+        }
+    }
+    double ms = elapsedMs(start, Clock::now());
+
+    ArenaStats end = arena.stats();
+    printArenaStats("after", end);
+    if (end.used + end.freeTotal != end.capacity || end.allocations != live.size()) {
+        std::printf("  arena bookkeeping is inconsistent\n");
+        return 1;
+    }
+    std::printf("  %d window steps, %zu alloc/free ops in %.2f ms (%.0f ns/op), %d grow(s)\n",
+                steps, ops, ms, ms * 1e6 / (double)ops, grows);
+    return 0;
+}
+
+// Meshes the whole region at each LOD scale, with every neighbour at the same scale.
+static int runLodBench(const BenchOptions& opt) {
+    RunResult r;
+    Region region;
+    buildRegion(region, opt.seed, opt.size, 1, r);
+
+    size_t fullVertices = 0;
+    for (int scale = 1; scale <= (1 << LOD_MAX_LEVEL); scale *= 2) {
+        int neighborScales[4] = { scale, scale, scale, scale };
+        size_t vertices = 0;
+        auto start = Clock::now();
+        for (auto* mc : region.chunks) {
+            Chunk lodChunk;
+            Chunk* src = &mc->chunk;
+            if (scale > 1) {
+                downsampleChunk(mc->chunk, scale, lodChunk);
+                src = &lodChunk;
+            }
+            std::vector<int> starts, cutoutStarts;
+            std::vector<float> cutout;
+            ChunkBorders borders;
+            borders.copyFrom(region.manager, mc->chunk.chunkX, mc->chunk.chunkZ, scale, neighborScales);
+            vertices += ChunkMesh::buildVertices(*src, borders, &starts, neighborScales,
+                                                 &cutout, &cutoutStarts).size() / ChunkMesh::floatsPerVertex;
+            vertices += cutout.size() / ChunkMesh::floatsPerVertex;
+        }
+        double ms = elapsedMs(start, Clock::now());
+        if (scale == 1) fullVertices = vertices;
+        std::printf("  scale %d: %10zu vertices (%5.1f%% of full) | %.1f vertices/chunk | %.3f ms/chunk\n",
+                    scale, vertices, fullVertices ? 100.0 * vertices / fullVertices : 0.0,
+                    (double)vertices / region.chunks.size(), ms / region.chunks.size());
+    }
+    return 0;
+}
+
+// Encodes and decodes every generated chunk (terrain and trees) runs times; throughput is in
+// raw block bytes per second.
+static int runCodecBench(const BenchOptions& opt) {
+    RunResult r;
+    Region region;
+    buildRegion(region, opt.seed, opt.size, 1, r);
+
+    size_t rawBytes = 0;
+    for (auto* mc : region.chunks) rawBytes += mc->chunk.blocks.size() * sizeof(Block);
+
+    std::vector<std::vector<uint8_t>> encoded(region.chunks.size());
+    std::vector<Block> copy;
+    Chunk decoded;
+    double copyMs = 0.0, encodeMs = 0.0, decodeMs = 0.0;
+    size_t encodedBytes = 0;
+    bool ok = true;
+    for (int run = 0; run < opt.runs; run++) {
+        auto start = Clock::now();
+        for (auto* mc : region.chunks) copy = mc->chunk.blocks;
+        copyMs += elapsedMs(start, Clock::now());
+
+        start = Clock::now();
+        for (size_t i = 0; i < region.chunks.size(); i++) encodeChunkBlocks(region.chunks[i]->chunk, encoded[i]);
+        encodeMs += elapsedMs(start, Clock::now());
+
+        start = Clock::now();
+        for (size_t i = 0; i < region.chunks.size(); i++) {
+            ok = decodeChunkBlocks(encoded[i].data(), encoded[i].size(), decoded) && ok;
+        }
+        decodeMs += elapsedMs(start, Clock::now());
+    }
+    for (size_t i = 0; i < region.chunks.size(); i++) {
+        encodedBytes += encoded[i].size();
+        decodeChunkBlocks(encoded[i].data(), encoded[i].size(), decoded);
+        ok = ok && decoded.blocks.size() == region.chunks[i]->chunk.blocks.size() &&
+             hashChunkBlocks(decoded) == hashChunkBlocks(region.chunks[i]->chunk);
+    }
+
+    auto gbps = [&](double ms) { return ms > 0.0 ? (double)rawBytes * opt.runs / (ms * 1e6) : 0.0; };
+    std::printf("codec: %zu chunks, %zu raw bytes/chunk (%zu bytes per block)\n",
+                region.chunks.size(), rawBytes / region.chunks.size(), sizeof(Block));
+    std::printf("  encoded %.0f bytes/chunk, ratio %.1fx, round trip %s\n",
+                (double)encodedBytes / region.chunks.size(), (double)rawBytes / encodedBytes, ok ? "ok" : "MISMATCH");
+    std::printf("  copy   %7.2f GB/s\n  encode %7.2f GB/s\n  decode %7.2f GB/s\n",
+                gbps(copyMs), gbps(encodeMs), gbps(decodeMs));
+    return ok ? 0 : 1;
+}
+
+// Walks the player along +x through updateChunks the way the game loop does, taking finished
+// meshes off g_completedMeshes between updates. Fails if the chunk pool keeps allocating after
+// the first crossings, or if a chunk is left without a mesh once the walk stops.
+static int runStreamBench(const BenchOptions& opt) {
+    const int radius = 6;
+    const int crossings = 400;
+    const int warmup = 100;
+    initPerlin(opt.seed);
+    ChunkManager manager;
+    glm::vec3 pos(8.0f, 70.0f, 8.0f);
+
+    size_t meshes = 0;
+    auto drain = [&]() {
+        CompletedMesh done;
+        while (g_completedMeshes.try_pop(done)) {
+            ManagedChunk* mc = manager.getChunk(done.cx, done.cz);
+            if (!mc) continue;
+            mc->mesh.vertices.swap(done.vertices);
+            g_vertexBuffers.release(std::move(done.vertices));
+            mc->meshDirty = false;
+            mc->meshUploaded = true;
+            mc->inMeshQueue = false;
+            meshes++;
+        }
+    };
+    auto generating = [&]() {
+        for (auto& pair : manager.chunks)
+            if (pair.second->inTerrainQueue) return true;
+        return false;
+    };
+    auto busy = [&]() {
+        for (auto& pair : manager.chunks)
+            if (pair.second->inTerrainQueue || pair.second->inMeshQueue) return true;
+        return false;
+    };
+
+    auto start = Clock::now();
+    ChunkPoolStats warm;
+    for (int step = 1; step <= crossings; step++) {
+        pos.x += 16.0f; // one chunk width
+        // Wait for the new ring's terrain, not its meshes: those are still being built on the
+        // workers when the next crossing unloads the trailing ring.
+        for (int i = 0; i < 5000; i++) {
+            updateChunks(manager, pos, radius, 0);
+            drain();
+            if (!generating()) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (step == warmup) warm = manager.pool.stats();
+    }
+    // Settle: let the last ring finish generating and meshing before checking and tearing down.
+    for (int i = 0; i < 5000 && busy(); i++) {
+        updateChunks(manager, pos, radius, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        drain();
+    }
+    double ms = elapsedMs(start, Clock::now());
+
+    ChunkPoolStats end = manager.pool.stats();
+    size_t unmeshed = 0;
+    for (auto& pair : manager.chunks)
+        if (pair.second->terrainGenerated && !pair.second->meshUploaded) unmeshed++;
+    std::printf("stream: seed %u, radius %d, %d chunk-border crossings in %.0f ms, %zu meshes\n",
+                opt.seed, radius, crossings, ms, meshes);
+    std::printf("  chunk pool: %zu allocations (%zu after crossing %d), %zu reuses, %zu idle, %zu loaded\n",
+                end.allocations, end.allocations - warm.allocations, warmup, end.reuses, end.idle,
+                manager.chunks.size());
+    bool ok = !busy() && unmeshed == 0 && end.allocations == warm.allocations;
+    if (busy()) std::printf("  jobs did not finish\n");
+    if (unmeshed) std::printf("  %zu generated chunks have no mesh\n", unmeshed);
+    if (end.allocations != warm.allocations) std::printf("  chunk pool still allocating after warm-up\n");
+    return ok ? 0 : 1;
+}
+
+static void printStage(const char* name, const StageTimes& s) {
+    std::printf("  %-8s wall %9.2f ms | per-chunk p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f ms\n",
+                name, s.wallMs,
+                percentile(s.perChunkMs, 0.50), percentile(s.perChunkMs, 0.90),
+                percentile(s.perChunkMs, 0.99), percentile(s.perChunkMs, 1.0));
+}
+
+static std::vector<int> parseList(const char* s) {
+    std::vector<int> out;
+    std::string str(s);
+    size_t pos = 0;
+    while (pos < str.size()) {
+        size_t comma = str.find(',', pos);
+        if (comma == std::string::npos) comma = str.size();
+        int v = std::atoi(str.substr(pos, comma - pos).c_str());
+        if (v > 0) out.push_back(v);
+        pos = comma + 1;
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    for (int i = 1; i < argc; i++) {
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--seed"))         opt.seed = (unsigned int)std::strtoul(next(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--size"))    opt.size = std::max(1, std::atoi(next()));
+        else if (!std::strcmp(argv[i], "--runs"))    opt.runs = std::max(1, std::atoi(next()));
+        else if (!std::strcmp(argv[i], "--threads")) opt.threadCounts = parseList(next());
+        else if (!std::strcmp(argv[i], "--write-goldens")) opt.writeGoldens = next();
+        else if (!std::strcmp(argv[i], "--verify"))  opt.verifyGoldens = next();
+        else if (!std::strcmp(argv[i], "--arena"))   opt.arena = true;
+        else if (!std::strcmp(argv[i], "--lod"))     opt.lod = true;
+        else if (!std::strcmp(argv[i], "--codec"))   opt.codec = true;
+        else if (!std::strcmp(argv[i], "--stream"))  opt.stream = true;
+        else {
+            std::printf("usage: %s [--seed N] [--size N] [--runs N] [--threads 1,2,4]\n"
+                        "       %s --write-goldens FILE | --verify FILE [--threads 1,2,4]\n"
+                        "       %s --arena [--size N]\n"
+                        "       %s --lod [--size N]\n"
+                        "       %s --codec [--size N] [--runs N]\n"
+                        "       %s --stream [--seed N]\n", argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+            return 1;
+        }
+    }
+    if (opt.threadCounts.empty()) {
+        int hw = (int)std::thread::hardware_concurrency();
+        opt.threadCounts = { 1, std::max(1, hw) };
+        if (opt.threadCounts[1] == 1) opt.threadCounts.pop_back();
+    }
+
+    if (!opt.writeGoldens.empty()) return writeGoldens(opt.writeGoldens);
+    if (!opt.verifyGoldens.empty()) return verifyGoldens(opt.verifyGoldens, opt.threadCounts);
+    if (opt.arena) return runArenaSim(opt);
+    if (opt.lod) return runLodBench(opt);
+    if (opt.codec) return runCodecBench(opt);
+    if (opt.stream) return runStreamBench(opt);
+
+    std::printf("worldgen_bench: seed %u, region %dx%d chunks, %d run(s)\n",
+                opt.seed, opt.size, opt.size, opt.runs);
+
+    for (int threads : opt.threadCounts) {
+        RunResult total;
+        for (int run = 0; run < opt.runs; run++) {
+            RunResult r = runOnce(opt, threads);
+            auto append = [](StageTimes& dst, const StageTimes& src) {
+                dst.perChunkMs.insert(dst.perChunkMs.end(), src.perChunkMs.begin(), src.perChunkMs.end());
+                dst.wallMs += src.wallMs;
+            };
+            append(total.terrain, r.terrain);
+            append(total.trees, r.trees);
+            append(total.mesh, r.mesh);
+            total.chunkCount += r.chunkCount;
+            total.vertexCount += r.vertexCount;
+            total.blockBytes += r.blockBytes;
+            total.meshBytes += r.meshBytes;
+        }
+
+        double wall = total.terrain.wallMs + total.trees.wallMs + total.mesh.wallMs;
+        double chunks = (double)total.chunkCount;
+
+        std::printf("\nthreads: %d\n", threads);
+        printStage("terrain", total.terrain);
+        printStage("trees", total.trees);
+        printStage("mesh", total.mesh);
+        std::printf("  chunks/s %.1f | vertices/chunk %.0f | bytes/chunk blocks %.0f mesh %.0f\n",
+                    chunks / (wall / 1000.0),
+                    total.vertexCount / chunks,
+                    total.blockBytes / chunks,
+                    total.meshBytes / chunks);
+    }
+    return 0;
+}
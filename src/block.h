@@ -1,20 +1,54 @@
 #pragma once
+#include "texture_atlas.h"
+#include <cstdint>
 
-enum BlockType {
-    AIR = 0,
-    GRASS,
-    DIRT,
-    STONE,
-    ANDESITE,
-    DIORITE,
-    GRANITE,
-    TUFF,
-    WOOD,
-    LEAVES,
-    SNOW
+// Every block type, in BlockType order. Faces are FRONT(-Z), BACK(+Z), LEFT(-X), RIGHT(+X),
+// BOTTOM(-Y), TOP(+Y); opaque = hides the faces behind it, solid = collides, transparent =
+// has see-through texels (meshed into the cutout pass).
+//        id         name        front             back              left              right             bottom            top               opaque solid  transparent
+#define VOXEL_BLOCK_LIST(X) \
+    X(AIR,      "Air",      LAYER_TUFF,       LAYER_TUFF,       LAYER_TUFF,       LAYER_TUFF,       LAYER_TUFF,       LAYER_TUFF,       false, false, false) \
+    X(GRASS,    "Grass",    LAYER_DIRT,       LAYER_DIRT,       LAYER_DIRT,       LAYER_DIRT,       LAYER_DIRT,       LAYER_GRASS_TOP,  true,  true,  false) \
+    X(DIRT,     "Dirt",     LAYER_DIRT,       LAYER_DIRT,       LAYER_DIRT,       LAYER_DIRT,       LAYER_DIRT,       LAYER_DIRT,       true,  true,  false) \
+    X(STONE,    "Stone",    LAYER_STONE,      LAYER_STONE,      LAYER_STONE,      LAYER_STONE,      LAYER_STONE,      LAYER_STONE,      true,  true,  false) \
+    X(ANDESITE, "Andesite", LAYER_ANDESITE,   LAYER_ANDESITE,   LAYER_ANDESITE,   LAYER_ANDESITE,   LAYER_ANDESITE,   LAYER_ANDESITE,   true,  true,  false) \
+    X(DIORITE,  "Diorite",  LAYER_DIORITE,    LAYER_DIORITE,    LAYER_DIORITE,    LAYER_DIORITE,    LAYER_DIORITE,    LAYER_DIORITE,    true,  true,  false) \
+    X(GRANITE,  "Granite",  LAYER_GRANITE,    LAYER_GRANITE,    LAYER_GRANITE,    LAYER_GRANITE,    LAYER_GRANITE,    LAYER_GRANITE,    true,  true,  false) \
+    X(TUFF,     "Tuff",     LAYER_TUFF,       LAYER_TUFF,       LAYER_TUFF,       LAYER_TUFF,       LAYER_TUFF,       LAYER_TUFF,       true,  true,  false) \
+    X(WOOD,     "Wood",     LAYER_OAK_SIDE,   LAYER_OAK_SIDE,   LAYER_OAK_SIDE,   LAYER_OAK_SIDE,   LAYER_OAK_TOP,    LAYER_OAK_TOP,    true,  true,  false) \
+    X(LEAVES,   "Leaves",   LAYER_LEAVES,     LAYER_LEAVES,     LAYER_LEAVES,     LAYER_LEAVES,     LAYER_LEAVES,     LAYER_LEAVES,     false, true,  true ) \
+    X(SNOW,     "Snow",     LAYER_SNOW,       LAYER_SNOW,       LAYER_SNOW,       LAYER_SNOW,       LAYER_SNOW,       LAYER_SNOW,       true,  true,  false)
+
+// One byte each, so a Block is two bytes: a chunk's blocks fit in 64 KB and fill/compare as
+// 16-bit words.
+enum BlockType : uint8_t {
+#define VOXEL_BLOCK_ENUM(id, ...) id,
+    VOXEL_BLOCK_LIST(VOXEL_BLOCK_ENUM)
+#undef VOXEL_BLOCK_ENUM
+    BLOCK_TYPE_COUNT
+};
+
+struct BlockInfo {
+    const char* name;
+    uint8_t faceLayers[6]; // TextureLayer per face
+    bool opaque;
+    bool solid;
+    bool transparent;
 };
 
-enum class LogAxis {
+// Dense per-type table, indexed by BlockType; read it through blockInfo().
+inline constexpr BlockInfo BLOCK_INFO[BLOCK_TYPE_COUNT] = {
+#define VOXEL_BLOCK_INFO(id, name, f0, f1, f2, f3, f4, f5, opaque, solid, transparent) \
+    { name, { f0, f1, f2, f3, f4, f5 }, opaque, solid, transparent },
+    VOXEL_BLOCK_LIST(VOXEL_BLOCK_INFO)
+#undef VOXEL_BLOCK_INFO
+};
+
+inline const BlockInfo& blockInfo(BlockType type) { return BLOCK_INFO[type]; }
+
+inline int getTextureLayer(BlockType type, int faceIndex) { return blockInfo(type).faceLayers[faceIndex]; }
+
+enum class LogAxis : uint8_t {
     Y = 0,
     X = 1,
     Z = 2
@@ -25,4 +59,4 @@ struct Block {
     LogAxis axis = LogAxis::Y;
 };
 
-float getVOffset(BlockType type, int faceIndex);
\ No newline at end of file
+static_assert(sizeof(Block) == 2, "Block is stored and serialised as two bytes");
@@ -1,6 +1,6 @@
 #include "chunk.h"
 #include "world.h"
-#include "texture_atlas.h"
+#include <algorithm>
 
 float cubeFaces[6][30] = {
     // ---------- FRONT -Z ----------
@@ -71,109 +71,204 @@ Chunk::Chunk(int cx, int cz, unsigned int w, unsigned int d, unsigned int h)
 }
 
 Block& Chunk::getBlock(int x, int y, int z) {
-    return blocks[x + width * (y + height * z)];
+    return blocks[index(x, y, z)];
 }
 
 void Chunk::setBlock(int x, int y, int z, BlockType type) {
-    blocks[x + width * (y + height * z)].type = type;
+    blocks[index(x, y, z)].type = type;
 }
 
-void ChunkMesh::appendFaceWithAtlas(float face[30], int x, int y, int z, int chunkX, int chunkZ,
-                                   int chunkWidth, int chunkDepth, Block& block, int faceIndex) {
-    float worldX = chunkX * chunkWidth + x;
-    float worldZ = chunkZ * chunkDepth + z;
+void Chunk::fillColumn(int x, int z, int yBegin, int yEnd, BlockType type) {
+    if (yBegin < 0) yBegin = 0;
+    if (yEnd > (int)height) yEnd = height;
+    if (yBegin >= yEnd) return;
 
-    AtlasTexture tex = g_textureAtlas.getTexture(block.type, faceIndex);
-    const AtlasConfig& config = g_textureAtlas.getConfig();
+    Block fill;
+    fill.type = type;
+    Block* col = column(x, z);
+    std::fill(col + yBegin, col + yEnd, fill);
+}
+
+void ChunkMesh::appendFace(float face[30], int x, int y, int z, int chunkX, int chunkZ,
+                           int chunkWidth, int chunkDepth, Block& block, int faceIndex, int scale) {
+    float worldX = (chunkX * chunkWidth + x) * scale;
+    float worldY = y * scale;
+    float worldZ = (chunkZ * chunkDepth + z) * scale;
 
-    float uScale = config.getUScale();
-    float vScale = config.getVScale();
-    float uOffset = g_textureAtlas.getUOffset(tex);
-    float vOffset = g_textureAtlas.getVOffset(tex);
+    uint32_t layer = blockInfo(block.type).faceLayers[faceIndex];
 
     for (int i = 0; i < 6; ++i) {
-        float u = face[i*5 + 3];
-        float v = face[i*5 + 4];
+        uint32_t u = face[i*5 + 3] > 0.5f;
+        uint32_t v = face[i*5 + 4] > 0.5f;
 
         // Handle log rotation for wood blocks
         if (block.type == WOOD) {
             if (faceIndex < 4) { // Side faces
                 if (block.axis == LogAxis::X) std::swap(u, v);
-                else if (block.axis == LogAxis::Z) u = 1.0f - u;
+                else if (block.axis == LogAxis::Z) u = 1 - u;
             }
         }
 
-        vertices.push_back(face[i*5 + 0] + worldX);
-        vertices.push_back(face[i*5 + 1] + y);
-        vertices.push_back(face[i*5 + 2] + worldZ);
-        vertices.push_back(u * uScale + uOffset);
-        vertices.push_back(v * vScale + vOffset);
+        // Corners sit at +-0.5 around the block centre; scaled blocks grow from their min corner.
+        vertices.push_back(((face[i*5 + 0] + 0.5f) * scale - 0.5f) + worldX);
+        vertices.push_back(((face[i*5 + 1] + 0.5f) * scale - 0.5f) + worldY);
+        vertices.push_back(((face[i*5 + 2] + 0.5f) * scale - 0.5f) + worldZ);
+        // Scaled (LOD) faces repeat the texture once per world block.
+        vertices.push_back(packVertexTexture(u * scale, v * scale, layer));
     }
 }
 
-void ChunkMesh::uploadToGPU(const std::vector<float>& newVertices) {
-    if (VAO == 0) glGenVertexArrays(1, &VAO);
-    if (VBO == 0) glGenBuffers(1, &VBO);
-
-    vertices = newVertices;
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-}
+void ChunkBorders::copyFrom(ChunkManager& manager, int cx, int cz, int scale, const int* neighborScales) {
+    const int offsets[4][2] = { { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+    for (int side = 0; side < 4; side++) {
+        ChunkBorder& border = sides[side];
+        ManagedChunk* n = manager.getChunk(cx + offsets[side][0], cz + offsets[side][1]);
+        if (!n || !n->terrainGenerated || n->inTerrainQueue) {
+            border.layers = 0;
+            continue;
+        }
+        const Chunk& nc = n->chunk;
+        bool alongX = side < 2;
+        border.length = alongX ? nc.width : nc.depth;
+        border.height = nc.height;
+        unsigned int across = alongX ? nc.depth : nc.width;
+        border.layers = (int)std::min<unsigned int>(std::max(scale, neighborScales ? neighborScales[side] : 1), across);
+        border.blocks.resize((size_t)border.layers * border.length * border.height);
 
-void ChunkMesh::draw() {
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 5);
+        // Columns are contiguous in Y, so each one is a single copy.
+        for (int layer = 0; layer < border.layers; layer++) {
+            int edge = (side == 0 || side == 2) ? (int)across - 1 - layer : layer;
+            for (int a = 0; a < (int)border.length; a++) {
+                size_t src = alongX ? nc.index(a, 0, edge) : nc.index(edge, 0, a);
+                std::copy_n(nc.blocks.begin() + src, nc.height,
+                            border.blocks.begin() + (size_t)border.height * (a + border.length * layer));
+            }
+        }
+    }
 }
 
-std::vector<float> ChunkMesh::buildVertices(Chunk& chunk, ChunkManager* manager) {
+std::vector<float> ChunkMesh::buildVertices(Chunk& chunk, const ChunkBorders& borders,
+                                            std::vector<int>* sectionStarts, const int* neighborScales,
+                                            std::vector<float>* cutoutVertices,
+                                            std::vector<int>* cutoutSectionStarts,
+                                            std::vector<float> storage) {
     ChunkMesh tmp;
+    ChunkMesh cutout;
+    tmp.vertices = std::move(storage);
     tmp.vertices.clear();
+    if (cutoutVertices) {
+        cutout.vertices.swap(*cutoutVertices);
+        cutout.vertices.clear();
+    }
+
+    const int s = chunk.scale;
 
-    ManagedChunk* neighborLeft  = manager->getChunk(chunk.chunkX - 1, chunk.chunkZ);
-    ManagedChunk* neighborRight = manager->getChunk(chunk.chunkX + 1, chunk.chunkZ);
-    ManagedChunk* neighborFront = manager->getChunk(chunk.chunkX, chunk.chunkZ - 1);
-    ManagedChunk* neighborBack  = manager->getChunk(chunk.chunkX, chunk.chunkZ + 1);
+    // A face is hidden by an opaque neighbour, or by a neighbour of the same non-opaque type
+    // (no faces between two leaves blocks).
+    auto hides = [](BlockType neighbor, BlockType self) {
+        return blockInfo(neighbor).opaque || neighbor == self;
+    };
 
-    auto isAir = [&](int bx, int by, int bz) -> bool {
+    // Whole aligned cell of the neighbour's full-res blocks next to (by, bz) / (bx, by) must hide
+    // the face. Cell size is the coarser of the two scales; at scale 1 this is a single block.
+    auto neighborHides = [&](int side, int a, int by, BlockType self) -> bool {
+        const ChunkBorder& n = borders.sides[side];
+        if (n.layers == 0) return false;
+        int g = std::max(s, neighborScales ? neighborScales[side] : 1);
+        int a0 = (a * s / g) * g;
+        int y0 = (by * s / g) * g;
+        for (int i = 0; i < g; i++) {
+            for (int y = y0; y < y0 + g; y++) {
+                for (int t = a0; t < a0 + g; t++) {
+                    if (!hides(n.get(i, t, y).type, self)) return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    auto faceVisible = [&](int bx, int by, int bz, BlockType self) -> bool {
         if (by < 0 || by >= (int)chunk.height) return true;
 
-        if (bx < 0)  return !neighborLeft  || neighborLeft->chunk.getBlock(chunk.width-1, by, bz).type == AIR;
-        if (bx >= (int)chunk.width)  return !neighborRight || neighborRight->chunk.getBlock(0, by, bz).type == AIR;
-        if (bz < 0)  return !neighborFront || neighborFront->chunk.getBlock(bx, by, chunk.depth-1).type == AIR;
-        if (bz >= (int)chunk.depth)  return !neighborBack  || neighborBack->chunk.getBlock(bx, by, 0).type == AIR;
+        if (bx < 0)  return !neighborHides(2, bz, by, self);
+        if (bx >= (int)chunk.width)  return !neighborHides(3, bz, by, self);
+        if (bz < 0)  return !neighborHides(0, bx, by, self);
+        if (bz >= (int)chunk.depth)  return !neighborHides(1, bx, by, self);
 
-        return chunk.getBlock(bx, by, bz).type == AIR;
+        return !hides(chunk.getBlock(bx, by, bz).type, self);
     };
 
-    for (int x = 0; x < (int)chunk.width; x++) {
-        for (int y = 0; y < (int)chunk.height; y++) {
-            for (int z = 0; z < (int)chunk.depth; z++) {
-                Block& block = chunk.getBlock(x, y, z);
-                if (block.type == AIR) continue;
-
-                if (isAir(x, y, z - 1)) tmp.appendFaceWithAtlas(cubeFaces[0], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 0);
-                if (isAir(x, y, z + 1)) tmp.appendFaceWithAtlas(cubeFaces[1], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 1);
-                if (isAir(x - 1, y, z)) tmp.appendFaceWithAtlas(cubeFaces[2], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 2);
-                if (isAir(x + 1, y, z)) tmp.appendFaceWithAtlas(cubeFaces[3], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 3);
-                if (isAir(x, y - 1, z)) tmp.appendFaceWithAtlas(cubeFaces[4], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 4);
-                if (isAir(x, y + 1, z)) tmp.appendFaceWithAtlas(cubeFaces[5], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 5);
+    if (sectionStarts) sectionStarts->clear();
+    if (cutoutSectionStarts) cutoutSectionStarts->clear();
+
+    // Sections are always sectionHeight world blocks tall, whatever the chunk's scale.
+    const int rowsPerSection = std::max(1, Chunk::sectionHeight / chunk.scale);
+    const int sections = ((int)chunk.height + rowsPerSection - 1) / rowsPerSection;
+
+    for (int section = 0; section < sections; section++) {
+        if (sectionStarts) sectionStarts->push_back(tmp.vertices.size() / floatsPerVertex);
+        if (cutoutSectionStarts) cutoutSectionStarts->push_back(cutout.vertices.size() / floatsPerVertex);
+        int yBegin = section * rowsPerSection;
+        int yEnd = std::min(yBegin + rowsPerSection, (int)chunk.height);
+
+        for (int z = 0; z < (int)chunk.depth; z++) {
+            for (int x = 0; x < (int)chunk.width; x++) {
+                for (int y = yBegin; y < yEnd; y++) {
+                    Block& block = chunk.getBlock(x, y, z);
+                    if (block.type == AIR) continue;
+
+                    // Blocks with see-through texels (leaves) go to the cutout mesh, drawn in a later pass.
+                    ChunkMesh* out = &tmp;
+                    if (blockInfo(block.type).transparent) {
+                        if (!cutoutVertices) continue;
+                        out = &cutout;
+                    }
+                    BlockType t = block.type;
+
+                    if (faceVisible(x, y, z - 1, t)) out->appendFace(cubeFaces[0], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 0, s);
+                    if (faceVisible(x, y, z + 1, t)) out->appendFace(cubeFaces[1], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 1, s);
+                    if (faceVisible(x - 1, y, z, t)) out->appendFace(cubeFaces[2], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 2, s);
+                    if (faceVisible(x + 1, y, z, t)) out->appendFace(cubeFaces[3], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 3, s);
+                    if (faceVisible(x, y - 1, z, t)) out->appendFace(cubeFaces[4], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 4, s);
+                    if (faceVisible(x, y + 1, z, t)) out->appendFace(cubeFaces[5], x, y, z, chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, block, 5, s);
+                }
             }
         }
     }
+    if (sectionStarts) sectionStarts->push_back(tmp.vertices.size() / floatsPerVertex);
+    if (cutoutSectionStarts) cutoutSectionStarts->push_back(cutout.vertices.size() / floatsPerVertex);
+    if (cutoutVertices) *cutoutVertices = std::move(cutout.vertices);
 
     return std::move(tmp.vertices);
 }
 
-void ChunkMesh::generateMesh(Chunk& chunk, ChunkManager* manager) {
-    auto built = ChunkMesh::buildVertices(chunk, manager);
-    uploadToGPU(built);
-}
+ManagedChunk::ManagedChunk(int cx, int cz) : chunk(cx, cz, 16, 16, 128) {}
+
+void ManagedChunk::reset(int cx, int cz) {
+    chunk.chunkX = cx;
+    chunk.chunkZ = cz;
+    chunk.scale = 1;
+    // Neighbours read a chunk's blocks before its terrain is generated; they must see air.
+    std::fill(chunk.blocks.begin(), chunk.blocks.end(), Block());
+
+    mesh.vertices.clear();
+    mesh.sectionStarts.clear();
+    mesh.sectionConnectivity.clear();
+    mesh.gpuRange = ArenaRange();
+    mesh.vertexCount = 0;
+    mesh.cutoutVertices.clear();
+    mesh.cutoutSectionStarts.clear();
+    mesh.cutoutGpuRange = ArenaRange();
+    mesh.cutoutVertexCount = 0;
 
-ManagedChunk::ManagedChunk(int cx, int cz) : chunk(cx, cz, 16, 16, 128) {}
\ No newline at end of file
+    terrainGenerated = false;
+    structuresGenerated = false;
+    meshUploaded = false;
+    meshDirty = true;
+    edited = false;
+    inTerrainQueue = false;
+    inStructQueue = false;
+    inMeshQueue = false;
+    meshScale = 1;
+    std::fill(meshNeighborScales, meshNeighborScales + 4, 1);
+}
\ No newline at end of file
@@ -1,38 +1,104 @@
 #pragma once
 #include "block.h"
+#include "vertex_arena.h"
 #include <vector>
-#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 struct ChunkManager;
 
 extern float cubeFaces[6][30];
 
 struct Chunk {
+    static constexpr int sectionHeight = 16; // vertical slice size used for culling
+
     unsigned int width = 16;
     unsigned int depth = 16;
     unsigned int height = 128;
     std::vector<Block> blocks;
     int chunkX, chunkZ;
+    int scale = 1; // world blocks per stored block along each axis (>1 for LOD copies, see lod.h)
 
     Chunk(int cx = 0, int cz = 0, unsigned int w = 16, unsigned int d = 16, unsigned int h = 128);
 
+    // Blocks are stored column-major: a whole Y column is contiguous.
+    size_t index(int x, int y, int z) const { return y + height * (x + width * z); }
+
     Block& getBlock(int x, int y, int z);
     void setBlock(int x, int y, int z, BlockType type);
+
+    Block* column(int x, int z) { return &blocks[index(x, 0, z)]; }
+    int sectionCount() const { return (height + sectionHeight - 1) / sectionHeight; }
+    void fillColumn(int x, int z, int yBegin, int yEnd, BlockType type); // [yBegin, yEnd)
+};
+
+// Second word of a vertex: texture u and v in whole tiles (repeat-wrapped, so merged or scaled
+// faces tile for free) and the texture array layer, bit-cast into the float vertex stream.
+// Only ever copied, never used in float arithmetic.
+inline float packVertexTexture(uint32_t u, uint32_t v, uint32_t layer) {
+    uint32_t bits = (u & 0xFF) | ((v & 0xFF) << 8) | (layer << 16);
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// The blocks of a chunk's four neighbours next to its sides, copied on the main thread so a
+// mesh job never reads another chunk (which may be unloaded and handed out again by the pool
+// while the job runs). Sides are -Z, +Z, -X, +X, like neighborScales; each keeps the `layers`
+// block planes nearest the shared edge, layer 0 touching it.
+struct ChunkBorder {
+    int layers = 0; // 0 when there is no neighbour with generated terrain on this side
+    unsigned int length = 16; // blocks along the edge
+    unsigned int height = 128;
+    std::vector<Block> blocks;
+
+    const Block& get(int layer, int along, int y) const { return blocks[y + height * (along + length * layer)]; }
+};
+
+struct ChunkBorders {
+    ChunkBorder sides[4];
+
+    // Copies enough layers for meshing chunk (cx, cz) at `scale` against neighbours drawn at
+    // neighborScales (nullptr = full resolution). Neighbours whose terrain is not generated yet
+    // count as missing: their blocks are air or still being written by a worker.
+    void copyFrom(ChunkManager& manager, int cx, int cz, int scale, const int* neighborScales);
 };
 
 struct ChunkMesh {
-    std::vector<float> vertices;
-    unsigned int VAO = 0, VBO = 0;
+    static const int floatsPerVertex = 4; // x, y, z, packed u/v/layer
 
-    static std::vector<float> buildVertices(Chunk& chunk, ChunkManager* manager);
+    // CPU copy of the vertices; empty once uploaded unless retention is on (chunk_renderer.h)
+    std::vector<float> vertices;
+    std::vector<int> sectionStarts; // first vertex of each section, plus the total count at the end
+    std::vector<uint64_t> sectionConnectivity; // per-section face visibility graph (visibility.h)
+    ArenaRange gpuRange; // slot in the shared GPU vertex buffer, managed by the render layer (chunk_renderer.h)
+    uint32_t vertexCount = 0; // uploaded vertices (gpuRange.count is rounded up to the arena granularity)
 
-    void generateMesh(Chunk& chunk, ChunkManager* manager);
+    // Leaves and other non-opaque blocks, drawn in a separate pass after all opaque geometry
+    std::vector<float> cutoutVertices;
+    std::vector<int> cutoutSectionStarts;
+    ArenaRange cutoutGpuRange;
+    uint32_t cutoutVertexCount = 0;
 
-    void appendFaceWithAtlas(float face[30], int x, int y, int z, int chunkX, int chunkZ,
-                            int chunkWidth, int chunkDepth, Block& block, int faceIndex);
+    // Vertices are emitted section by section (bottom to top), so each section is one contiguous range.
+    // chunk may be a downsampled LOD copy (chunk.scale > 1); neighbours are always read at full
+    // resolution from borders, copied with the same scale and neighborScales. neighborScales (-Z, +Z, -X, +X) is the LOD scale each neighbour is
+    // drawn at: a side face is only culled when the neighbour is solid at both scales, so seams
+    // between detail levels stay closed. nullptr means every neighbour is full resolution.
+    // Transparent blocks (leaves) go to cutoutVertices/cutoutSectionStarts instead, laid out the
+    // same way; with no cutoutVertices they are left out.
+    // The returned vertices are built in storage and the cutout ones in *cutoutVertices, reusing
+    // whatever capacity they already have (see VertexBufferPool in world.h).
+    static std::vector<float> buildVertices(Chunk& chunk, const ChunkBorders& borders,
+                                            std::vector<int>* sectionStarts = nullptr,
+                                            const int* neighborScales = nullptr,
+                                            std::vector<float>* cutoutVertices = nullptr,
+                                            std::vector<int>* cutoutSectionStarts = nullptr,
+                                            std::vector<float> storage = std::vector<float>());
 
-    void uploadToGPU(const std::vector<float>& newVertices); // prebuild vertex buffer
-    void draw();
+    void appendFace(float face[30], int x, int y, int z, int chunkX, int chunkZ,
+                    int chunkWidth, int chunkDepth, Block& block, int faceIndex, int scale = 1);
 };
 
 struct ManagedChunk {
@@ -43,11 +109,20 @@ struct ManagedChunk {
     bool structuresGenerated = false;
     bool meshUploaded = false;
     bool meshDirty = true;
+    bool edited = false; // changed by the player since it was loaded; saved to the region files on unload
 
     // Async scheduling flags
     bool inTerrainQueue = false;
     bool inStructQueue = false;
     bool inMeshQueue = false;
 
+    // LOD scale the current mesh was built at, and the scales its -Z, +Z, -X, +X neighbours had then
+    int meshScale = 1;
+    int meshNeighborScales[4] = { 1, 1, 1, 1 };
+
     ManagedChunk(int cx, int cz);
+
+    // Makes a pooled chunk a fresh, empty chunk at (cx, cz). Block and vertex storage keep their
+    // capacity; GPU ranges must already have been released.
+    void reset(int cx, int cz);
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "chunk_cache.h"
+#include "chunk_codec.h"
+#include <algorithm>
+
+ChunkCacheSettings g_chunkCacheSettings;
+ChunkCache g_chunkCache;
+
+uint64_t ChunkCache::beginStore(int cx, int cz) {
+    std::lock_guard<std::mutex> lock(mtx);
+    uint64_t ticket = nextTicket++;
+    pendingStores[{cx, cz}] = ticket;
+    return ticket;
+}
+
+void ChunkCache::store(const Chunk& chunk, uint64_t ticket) {
+    std::vector<uint8_t> data;
+    encodeChunkBlocks(chunk, data);
+    data.shrink_to_fit();
+
+    Key key(chunk.chunkX, chunk.chunkZ);
+    std::lock_guard<std::mutex> lock(mtx);
+    // Superseded by a later unload, or the chunk was loaded again while this one was encoding.
+    auto pending = pendingStores.find(key);
+    if (pending == pendingStores.end() || pending->second != ticket) return;
+    pendingStores.erase(pending);
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        bytes -= it->second.data.size();
+        lru.erase(it->second.lruPos);
+        entries.erase(it);
+    }
+    lru.push_front(key);
+    bytes += data.size();
+    entries[key] = Entry{ std::move(data), lru.begin() };
+    evictToBudget();
+}
+
+bool ChunkCache::take(Chunk& chunk) {
+    std::vector<uint8_t> data;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        Key key(chunk.chunkX, chunk.chunkZ);
+        if (pendingStores.erase(key)) {
+            // A store of this position is still in flight: whatever is cached is older than it.
+            auto stale = entries.find(key);
+            if (stale != entries.end()) {
+                bytes -= stale->second.data.size();
+                lru.erase(stale->second.lruPos);
+                entries.erase(stale);
+            }
+        }
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            counters.misses++;
+            return false;
+        }
+        data = std::move(it->second.data);
+        bytes -= data.size();
+        lru.erase(it->second.lruPos);
+        entries.erase(it);
+        counters.hits++;
+    }
+    return decodeChunkBlocks(data.data(), data.size(), chunk);
+}
+
+void ChunkCache::evictToBudget() {
+    size_t limit = std::min(budget, byteLimit);
+    while (bytes > limit && !lru.empty()) {
+        auto it = entries.find(lru.back());
+        bytes -= it->second.data.size();
+        entries.erase(it);
+        lru.pop_back();
+        counters.evictions++;
+    }
+}
+
+void ChunkCache::setBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (budget == bytes) return;
+    budget = bytes;
+    evictToBudget();
+}
+
+void ChunkCache::setByteLimit(size_t limit) {
+    std::lock_guard<std::mutex> lock(mtx);
+    byteLimit = limit;
+    evictToBudget();
+}
+
+void ChunkCache::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    entries.clear();
+    lru.clear();
+    pendingStores.clear();
+    bytes = 0;
+}
+
+ChunkCacheStats ChunkCache::stats() {
+    std::lock_guard<std::mutex> lock(mtx);
+    ChunkCacheStats s = counters;
+    s.entries = entries.size();
+    s.bytes = bytes;
+    return s;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "chunk.h"
+#include "world.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct ChunkCacheSettings {
+    int budgetMB = 64; // compressed bytes kept for unloaded chunks; main thread only, see setBudget
+};
+
+extern ChunkCacheSettings g_chunkCacheSettings;
+
+struct ChunkCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+
+    float hitRate() const { return hits + misses ? (float)hits / (float)(hits + misses) : 0.0f; }
+};
+
+// Recently unloaded chunks, kept encoded (chunk_codec.h) so walking back over the same ground
+// decodes them instead of generating terrain and trees again. Least recently stored entries
+// are dropped once the total goes over the budget. Thread-safe: chunks are stored and taken on
+// the generation workers.
+//
+// Stores run asynchronously after an unload, so a store is ticketed on the main thread when the
+// chunk unloads. A take() of the same coordinates cancels stores still in flight, and only the
+// newest ticket for a position may land, so a late store can never leave a stale entry behind.
+class ChunkCache {
+public:
+    // Main thread, when the chunk at (cx, cz) unloads: returns the ticket to store it with.
+    uint64_t beginStore(int cx, int cz);
+    // Encodes and keeps the blocks of a fully generated chunk (terrain and trees), unless the
+    // ticket was superseded or cancelled in the meantime.
+    void store(const Chunk& chunk, uint64_t ticket);
+    // Decodes a cached chunk into chunk and drops the entry; false on a miss (including while a
+    // store of the chunk is still in flight, which this cancels).
+    bool take(Chunk& chunk);
+
+    void clear();
+    ChunkCacheStats stats();
+
+    // Main thread, once per frame: mirrors g_chunkCacheSettings.budgetMB (in bytes) into the
+    // cache for the workers and evicts down to it.
+    void setBudget(size_t bytes);
+
+    // Caps the cache below its configured budget and evicts down to it (see memory_budget.h);
+    // SIZE_MAX lifts the cap.
+    void setByteLimit(size_t limit);
+
+private:
+    typedef std::pair<int,int> Key;
+    struct Entry {
+        std::vector<uint8_t> data;
+        std::list<Key>::iterator lruPos;
+    };
+
+    std::mutex mtx;
+    std::unordered_map<Key, Entry, pair_hash> entries;
+    std::list<Key> lru; // most recent at the front
+    std::unordered_map<Key, uint64_t, pair_hash> pendingStores; // newest ticket per position
+    uint64_t nextTicket = 1;
+    size_t bytes = 0;
+    size_t budget = (size_t)ChunkCacheSettings().budgetMB << 20;
+    size_t byteLimit = SIZE_MAX;
+    ChunkCacheStats counters;
+
+    void evictToBudget();
+};
+
+extern ChunkCache g_chunkCache;
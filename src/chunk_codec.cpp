@@ -0,0 +1,200 @@
+#include "chunk_codec.h"
+#include <algorithm>
+#include <cstring>
+
+static const uint8_t CODEC_VERSION = 1;
+static const uint8_t DELTA_VERSION = 2;
+
+static void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end) return false;
+        uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static inline bool sameBlock(const Block& a, const Block& b) {
+    return a.type == b.type && a.axis == b.axis;
+}
+
+static inline bool validBlock(uint8_t type, uint8_t axis) {
+    return type < BLOCK_TYPE_COUNT && axis <= (uint8_t)LogAxis::Z;
+}
+
+// Layout: version, width, depth, height (varints), palette size, palette entries (type, axis),
+// then one varint token per run: (run length - 1) << paletteBits | palette index.
+// Generated chunks use a handful of block kinds, so most runs cost one or two bytes.
+void encodeChunkBlocks(const Chunk& chunk, std::vector<uint8_t>& out) {
+    out.clear();
+    out.push_back(CODEC_VERSION);
+    putVarint(out, chunk.width);
+    putVarint(out, chunk.depth);
+    putVarint(out, chunk.height);
+
+    const std::vector<Block>& blocks = chunk.blocks;
+    // Every (type, axis) pair has a slot, so building the palette is one table lookup per block.
+    const int AXES = (int)LogAxis::Z + 1;
+    int paletteIndex[BLOCK_TYPE_COUNT * AXES];
+    std::fill(paletteIndex, paletteIndex + BLOCK_TYPE_COUNT * AXES, -1);
+    auto slot = [AXES](const Block& b) { return b.type * AXES + (int)b.axis; };
+    std::vector<Block> palette;
+    for (const Block& b : blocks) {
+        if (paletteIndex[slot(b)] < 0) {
+            paletteIndex[slot(b)] = (int)palette.size();
+            palette.push_back(b);
+        }
+    }
+    uint32_t bits = 0;
+    while ((1u << bits) < palette.size()) bits++;
+
+    out.push_back((uint8_t)(palette.size() - 1));
+    for (const Block& b : palette) {
+        out.push_back((uint8_t)b.type);
+        out.push_back((uint8_t)b.axis);
+    }
+
+    size_t i = 0;
+    while (i < blocks.size()) {
+        const Block& b = blocks[i];
+        size_t run = 1;
+        while (i + run < blocks.size() && sameBlock(blocks[i + run], b)) run++;
+        putVarint(out, ((uint32_t)(run - 1) << bits) | (uint32_t)paletteIndex[slot(b)]);
+        i += run;
+    }
+}
+
+bool decodeChunkBlocks(const uint8_t* data, size_t size, Chunk& chunk) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    if (p == end || *p++ != CODEC_VERSION) return false;
+
+    uint32_t w, d, h;
+    if (!getVarint(p, end, w) || !getVarint(p, end, d) || !getVarint(p, end, h)) return false;
+    if (w != chunk.width || d != chunk.depth || h != chunk.height) return false;
+
+    if (p == end) return false;
+    uint32_t paletteSize = (uint32_t)*p++ + 1;
+    if ((size_t)(end - p) < paletteSize * 2) return false;
+    Block palette[256];
+    for (uint32_t k = 0; k < paletteSize; k++, p += 2) {
+        if (!validBlock(p[0], p[1])) return false;
+        palette[k].type = (BlockType)p[0];
+        palette[k].axis = (LogAxis)p[1];
+    }
+    uint32_t bits = 0;
+    while ((1u << bits) < paletteSize) bits++;
+    const uint32_t mask = (1u << bits) - 1;
+
+    Block splat[256][8];
+    for (uint32_t k = 0; k < paletteSize; k++) std::fill(splat[k], splat[k] + 8, palette[k]);
+
+    Block* out = chunk.blocks.data();
+    Block* outEnd = out + chunk.blocks.size();
+    while (out < outEnd) {
+        uint32_t token;
+        // Most tokens are a single byte; skip the general varint loop for them.
+        if (p != end && *p < 0x80) token = *p++;
+        else if (!getVarint(p, end, token)) return false;
+
+        uint32_t index = token & mask;
+        size_t run = (size_t)(token >> bits) + 1;
+        if (index >= paletteSize || run > (size_t)(outEnd - out)) return false;
+        // Long runs are written 8 blocks (16 bytes) at a time from a pre-splatted pattern, which
+        // the compiler turns into single vector stores.
+        const Block* pattern = splat[index];
+        Block* runEnd = out + run;
+        while (runEnd - out >= 8) {
+            std::memcpy(out, pattern, 8 * sizeof(Block));
+            out += 8;
+        }
+        while (out < runEnd) *out++ = pattern[0];
+    }
+    return p == end;
+}
+
+// Layout: version, generator version, width, depth, height (varints), then (skip varint, length
+// varint, length x (type, axis)) runs until the end of the data.
+void encodeChunkDelta(const Chunk& chunk, const Chunk& base, uint32_t generatorVersion, std::vector<uint8_t>& out) {
+    out.clear();
+    out.push_back(DELTA_VERSION);
+    putVarint(out, generatorVersion);
+    putVarint(out, chunk.width);
+    putVarint(out, chunk.depth);
+    putVarint(out, chunk.height);
+
+    const std::vector<Block>& blocks = chunk.blocks;
+    const std::vector<Block>& baseBlocks = base.blocks;
+    size_t i = 0;
+    size_t runEnd = 0; // end of the previous run
+    while (i < blocks.size()) {
+        if (sameBlock(blocks[i], baseBlocks[i])) {
+            i++;
+            continue;
+        }
+        size_t run = 1;
+        while (i + run < blocks.size() && !sameBlock(blocks[i + run], baseBlocks[i + run])) run++;
+        putVarint(out, (uint32_t)(i - runEnd));
+        putVarint(out, (uint32_t)run);
+        for (size_t k = i; k < i + run; k++) {
+            out.push_back((uint8_t)blocks[k].type);
+            out.push_back((uint8_t)blocks[k].axis);
+        }
+        i += run;
+        runEnd = i;
+    }
+}
+
+bool isChunkDelta(const uint8_t* data, size_t size) {
+    return size > 0 && data[0] == DELTA_VERSION;
+}
+
+static bool readDeltaHeader(const uint8_t*& p, const uint8_t* end, uint32_t& generatorVersion) {
+    if (p == end || *p++ != DELTA_VERSION) return false;
+    return getVarint(p, end, generatorVersion);
+}
+
+uint32_t chunkDeltaGeneratorVersion(const uint8_t* data, size_t size) {
+    const uint8_t* p = data;
+    uint32_t generatorVersion;
+    return readDeltaHeader(p, data + size, generatorVersion) ? generatorVersion : 0;
+}
+
+bool applyChunkDelta(const uint8_t* data, size_t size, Chunk& chunk) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    uint32_t generatorVersion;
+    if (!readDeltaHeader(p, end, generatorVersion)) return false;
+
+    uint32_t w, d, h;
+    if (!getVarint(p, end, w) || !getVarint(p, end, d) || !getVarint(p, end, h)) return false;
+    if (w != chunk.width || d != chunk.depth || h != chunk.height) return false;
+
+    std::vector<Block>& blocks = chunk.blocks;
+    size_t i = 0;
+    while (p != end) {
+        uint32_t skip, run;
+        if (!getVarint(p, end, skip) || !getVarint(p, end, run)) return false;
+        if (run == 0 || skip > blocks.size() - i || run > blocks.size() - i - skip) return false;
+        if ((size_t)(end - p) < (size_t)run * 2) return false;
+        i += skip;
+        for (uint32_t k = 0; k < run; k++, i++) {
+            uint8_t type = *p++;
+            uint8_t axis = *p++;
+            if (!validBlock(type, axis)) return false;
+            blocks[i].type = (BlockType)type;
+            blocks[i].axis = (LogAxis)axis;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "chunk.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Compact serialised form of a chunk's block data, used by the region files.
+// A palette of the chunk's distinct blocks, then runs of identical blocks along the column-major
+// storage order, each one varint of (length, palette index): the long AIR and STONE stretches of
+// every column collapse to a byte or two. Decoding is a stream of block fills.
+void encodeChunkBlocks(const Chunk& chunk, std::vector<uint8_t>& out);
+
+// Returns false (leaving chunk partly written) if the data is truncated or does not match
+// the chunk's dimensions.
+bool decodeChunkBlocks(const uint8_t* data, size_t size, Chunk& chunk);
+
+// Edit delta: only the blocks where chunk differs from base (the chunk as generateTerrainForChunk
+// produces it), as (skip, run of new blocks) pairs along the storage order. An untouched chunk
+// encodes to a few bytes. generatorVersion identifies the terrain generator that made base.
+void encodeChunkDelta(const Chunk& chunk, const Chunk& base, uint32_t generatorVersion, std::vector<uint8_t>& out);
+
+bool isChunkDelta(const uint8_t* data, size_t size);
+
+// Generator version stored in a delta's header; 0 if the header is unreadable.
+uint32_t chunkDeltaGeneratorVersion(const uint8_t* data, size_t size);
+
+// Overwrites the changed blocks; chunk must already hold the freshly generated base terrain.
+bool applyChunkDelta(const uint8_t* data, size_t size, Chunk& chunk);
@@ -0,0 +1,409 @@
+#include "chunk_renderer.h"
+#include "visibility.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+
+bool g_occlusionCulling = true;
+
+struct GpuVertexArena {
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    VertexArenaAllocator allocator;
+};
+
+static GpuVertexArena g_arena;
+static const uint32_t ARENA_INITIAL_VERTICES = 1u << 21; // 2M vertices, grows by doubling
+static const size_t VERTEX_BYTES = ChunkMesh::floatsPerVertex * sizeof(float);
+
+static void bindArenaAttributes() {
+    glBindVertexArray(g_arena.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, g_arena.VBO);
+
+    const int stride = (int)VERTEX_BYTES;
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+}
+
+bool initChunkRenderer() {
+    glGenVertexArrays(1, &g_arena.VAO);
+    glGenBuffers(1, &g_arena.VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, g_arena.VBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)ARENA_INITIAL_VERTICES * VERTEX_BYTES, nullptr, GL_DYNAMIC_DRAW);
+    g_arena.allocator = VertexArenaAllocator(ARENA_INITIAL_VERTICES);
+    bindArenaAttributes();
+    return g_arena.VAO != 0 && g_arena.VBO != 0;
+}
+
+void shutdownChunkRenderer() {
+    if (g_arena.VBO) glDeleteBuffers(1, &g_arena.VBO);
+    if (g_arena.VAO) glDeleteVertexArrays(1, &g_arena.VAO);
+    g_arena = GpuVertexArena();
+}
+
+// Doubles the GPU buffer until `needed` more vertices fit, copying the live data across.
+static void growArena(uint32_t needed) {
+    uint32_t oldCapacity = g_arena.allocator.capacity();
+    uint32_t newCapacity = oldCapacity ? oldCapacity : ARENA_INITIAL_VERTICES;
+    while (newCapacity - oldCapacity < needed + VertexArenaAllocator::granularity) newCapacity *= 2;
+
+    GLuint newVBO;
+    glGenBuffers(1, &newVBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newVBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newCapacity * VERTEX_BYTES, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, g_arena.VBO);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)oldCapacity * VERTEX_BYTES);
+    glDeleteBuffers(1, &g_arena.VBO);
+
+    g_arena.VBO = newVBO;
+    g_arena.allocator.grow(newCapacity);
+    bindArenaAttributes();
+}
+
+// Replaces whatever `range` held with the given vertices.
+static void uploadToArena(ArenaRange& range, const std::vector<float>& vertices) {
+    uint32_t count = (uint32_t)(vertices.size() / ChunkMesh::floatsPerVertex);
+    g_arena.allocator.free(range);
+    if (!g_arena.allocator.allocate(count, range)) {
+        growArena(count);
+        g_arena.allocator.allocate(count, range);
+    }
+    if (count == 0) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, g_arena.VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)range.offset * VERTEX_BYTES,
+                    (GLsizeiptr)count * VERTEX_BYTES, vertices.data());
+}
+
+// Bumped whenever a chunk's cutout geometry appears, changes or goes away, so the cached
+// back-to-front order (which holds ManagedChunk pointers) is rebuilt before its next use.
+static uint64_t g_cutoutGeneration = 0;
+
+MeshRetentionSettings g_meshRetention;
+
+// Uploads vertices, then keeps them in retained (when retention is on) or hands them back to
+// the vertex buffer pool. Whatever retained held before goes back to the pool either way.
+static uint32_t uploadVertices(ArenaRange& range, std::vector<float>& vertices, std::vector<float>& retained) {
+    uploadToArena(range, vertices);
+    uint32_t count = (uint32_t)(vertices.size() / ChunkMesh::floatsPerVertex);
+    if (g_meshRetention.retainCpuVertices) retained.swap(vertices);
+    g_vertexBuffers.release(std::move(vertices));
+    if (!g_meshRetention.retainCpuVertices) g_vertexBuffers.release(std::move(retained));
+    return count;
+}
+
+void uploadChunkMesh(ChunkMesh& mesh, CompletedMesh& completed) {
+    mesh.sectionStarts = std::move(completed.sectionStarts);
+    mesh.sectionConnectivity = std::move(completed.sectionConnectivity);
+    mesh.vertexCount = uploadVertices(mesh.gpuRange, completed.vertices, mesh.vertices);
+
+    if (mesh.cutoutGpuRange.count != 0 || !completed.cutoutVertices.empty()) g_cutoutGeneration++;
+    mesh.cutoutSectionStarts = std::move(completed.cutoutSectionStarts);
+    mesh.cutoutVertexCount = uploadVertices(mesh.cutoutGpuRange, completed.cutoutVertices, mesh.cutoutVertices);
+}
+
+MeshMemoryStats getMeshMemoryStats(ChunkManager& manager) {
+    MeshMemoryStats s;
+    for (auto& pair : manager.chunks) {
+        const ChunkMesh& mesh = pair.second->mesh;
+        s.gpuBytes += (size_t)(mesh.vertexCount + mesh.cutoutVertexCount) * VERTEX_BYTES;
+        s.cpuBytes += (mesh.vertices.capacity() + mesh.cutoutVertices.capacity()) * sizeof(float);
+    }
+    s.spareBytes = g_vertexBuffers.spareBytes();
+    return s;
+}
+
+void releaseChunkMesh(ChunkMesh& mesh) {
+    g_arena.allocator.free(mesh.gpuRange);
+    if (mesh.cutoutGpuRange.count != 0) g_cutoutGeneration++;
+    g_arena.allocator.free(mesh.cutoutGpuRange);
+}
+
+ArenaStats getChunkArenaStats() {
+    return g_arena.allocator.stats();
+}
+
+size_t getChunkArenaBytes() {
+    return (size_t)g_arena.allocator.stats().used * VERTEX_BYTES;
+}
+
+// Queued draw ranges for the frame's single glMultiDrawArrays call
+static std::vector<GLint> g_drawFirsts;
+static std::vector<GLsizei> g_drawCounts;
+
+// Sections that passed culling in this frame's opaque pass, reused by the cutout pass
+static std::unordered_map<const ManagedChunk*, uint32_t> g_visibleSectionMasks;
+
+// Queues the sections whose bit is set in mask, merging adjacent ones into one range.
+static void queueSectionMask(const ChunkMesh& mesh, uint32_t mask, RenderStats& stats) {
+    const std::vector<int>& starts = mesh.sectionStarts;
+    int sections = (int)starts.size() - 1;
+
+    int s = 0;
+    while (s < sections) {
+        bool empty = starts[s + 1] == starts[s];
+        if (empty) { s++; continue; }
+        if (!(mask & (1u << s))) { s++; continue; }
+
+        int first = starts[s];
+        while (s < sections && ((mask & (1u << s)) || starts[s + 1] == starts[s])) {
+            if (starts[s + 1] != starts[s]) stats.visibleSections++;
+            s++;
+        }
+        g_drawFirsts.push_back((GLint)(mesh.gpuRange.offset + first));
+        g_drawCounts.push_back((GLsizei)(starts[s] - first));
+        stats.drawRanges++;
+    }
+}
+
+static void submitQueuedDraws(RenderStats& stats) {
+    if (g_drawFirsts.empty()) return;
+    glBindVertexArray(g_arena.VAO);
+    glMultiDrawArrays(GL_TRIANGLES, g_drawFirsts.data(), g_drawCounts.data(), (GLsizei)g_drawFirsts.size());
+    stats.drawCalls++;
+    for (GLsizei count : g_drawCounts) stats.drawnVertices += (uint64_t)count;
+}
+
+static int sectionVertexCount(const std::vector<int>& starts, int s) {
+    if (s + 1 >= (int)starts.size()) return 0;
+    return starts[s + 1] - starts[s];
+}
+
+static int countNonEmptySections(const ChunkMesh& mesh) {
+    int n = 0;
+    for (size_t s = 0; s + 1 < mesh.sectionStarts.size(); s++) {
+        if (mesh.sectionStarts[s + 1] != mesh.sectionStarts[s]) n++;
+    }
+    return n;
+}
+
+void drawVisibleChunks(ChunkManager& manager, const glm::mat4& viewProj, const glm::vec3& cameraPos,
+                       RenderStats& stats) {
+    // Reused between frames to avoid reallocating every frame
+    static std::vector<ManagedChunk*> candidates;
+    static CullBoxes chunkBoxes;
+    static CullBoxes sectionBoxes;
+    static std::vector<uint8_t> chunkVisible;
+    static std::vector<uint8_t> sectionVisible;
+    static std::vector<VisibleChunk> reachable;
+    static std::vector<VisibleChunk> outsideFrustum;
+    static std::unordered_set<const ManagedChunk*> inFrustumChunks;
+
+    stats = RenderStats();
+    stats.meshMemory = getMeshMemoryStats(manager);
+    Frustum frustum = Frustum::fromMatrix(viewProj);
+    g_drawFirsts.clear();
+    g_drawCounts.clear();
+    g_visibleSectionMasks.clear();
+
+    candidates.clear();
+    chunkBoxes.clear();
+    for (auto& pair : manager.chunks) {
+        ManagedChunk* mc = pair.second;
+        const ChunkMesh& mesh = mc->mesh;
+        bool hasCutout = mesh.cutoutGpuRange.count != 0 && mesh.cutoutSectionStarts.size() >= 2;
+        if ((mesh.gpuRange.count == 0 || mesh.sectionStarts.size() < 2 || mesh.sectionStarts.back() == 0) &&
+            !hasCutout) {
+            stats.emptyChunks++;
+            continue;
+        }
+
+        // Tighten the box vertically to the sections that actually have geometry in either pass.
+        int sections = (int)std::max(mesh.sectionStarts.size(), mesh.cutoutSectionStarts.size()) - 1;
+        auto sectionEmpty = [&](int s) {
+            return sectionVertexCount(mesh.sectionStarts, s) == 0 && sectionVertexCount(mesh.cutoutSectionStarts, s) == 0;
+        };
+        int lo = 0, hi = sections - 1;
+        while (lo < hi && sectionEmpty(lo)) lo++;
+        while (hi > lo && sectionEmpty(hi)) hi--;
+
+        const Chunk& c = mc->chunk;
+        glm::vec3 min(c.chunkX * (float)c.width - 0.5f, lo * (float)Chunk::sectionHeight - 0.5f, c.chunkZ * (float)c.depth - 0.5f);
+        glm::vec3 max(min.x + c.width, (hi + 1) * (float)Chunk::sectionHeight - 0.5f, min.z + c.depth);
+        chunkBoxes.add(min, max);
+        candidates.push_back(mc);
+    }
+
+    cullBoxes(frustum, chunkBoxes, chunkVisible);
+
+    if (g_occlusionCulling && findVisibleSections(manager, cameraPos, frustum, reachable, &outsideFrustum)) {
+        // The BFS already frustum-tests every section it enters.
+        int inFrustumSections = 0;
+        inFrustumChunks.clear();
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (chunkVisible[i]) {
+                inFrustumSections += countNonEmptySections(candidates[i]->mesh);
+                inFrustumChunks.insert(candidates[i]);
+            } else {
+                stats.culledChunks++;
+            }
+        }
+        // Counted as on the frustum-only path: non-empty sections of chunks in the frustum.
+        for (const VisibleChunk& vc : outsideFrustum) {
+            if (!inFrustumChunks.count(vc.chunk)) continue;
+            for (int s = 0; s + 1 < (int)vc.chunk->mesh.sectionStarts.size(); s++) {
+                if ((vc.sectionMask >> s & 1u) && sectionVertexCount(vc.chunk->mesh.sectionStarts, s) != 0) {
+                    stats.culledSections++;
+                }
+            }
+        }
+        for (const VisibleChunk& vc : reachable) {
+            const ChunkMesh& mesh = vc.chunk->mesh;
+            g_visibleSectionMasks[vc.chunk] = vc.sectionMask;
+            if (mesh.gpuRange.count == 0 || mesh.sectionStarts.size() < 2) continue;
+            int before = stats.visibleSections;
+            queueSectionMask(mesh, vc.sectionMask, stats);
+            if (stats.visibleSections > before) stats.visibleChunks++;
+        }
+        stats.occludedSections = std::max(0, inFrustumSections - stats.culledSections - stats.visibleSections);
+        submitQueuedDraws(stats);
+        return;
+    }
+
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (!chunkVisible[i]) {
+            stats.culledChunks++;
+            continue;
+        }
+        stats.visibleChunks++;
+
+        ManagedChunk* mc = candidates[i];
+        const Chunk& c = mc->chunk;
+        int sections = (int)std::max(mc->mesh.sectionStarts.size(), mc->mesh.cutoutSectionStarts.size()) - 1;
+
+        sectionBoxes.clear();
+        for (int s = 0; s < sections; s++) {
+            glm::vec3 min(c.chunkX * (float)c.width - 0.5f, s * (float)Chunk::sectionHeight - 0.5f, c.chunkZ * (float)c.depth - 0.5f);
+            glm::vec3 max = min + glm::vec3((float)c.width, (float)Chunk::sectionHeight, (float)c.depth);
+            sectionBoxes.add(min, max);
+        }
+        cullBoxes(frustum, sectionBoxes, sectionVisible);
+
+        uint32_t mask = 0;
+        for (int s = 0; s < sections; s++) {
+            if (sectionVisible[s]) mask |= 1u << s;
+            else if (sectionVertexCount(mc->mesh.sectionStarts, s) != 0) stats.culledSections++;
+        }
+        g_visibleSectionMasks[mc] = mask;
+        if (mc->mesh.sectionStarts.size() >= 2) queueSectionMask(mc->mesh, mask, stats);
+    }
+    submitQueuedDraws(stats);
+}
+
+struct CutoutSection {
+    const ManagedChunk* chunk;
+    int section;
+    float distance2;
+};
+
+void drawCutoutChunks(ChunkManager& manager, const glm::vec3& cameraPos, RenderStats& stats) {
+    // Back-to-front order of every non-empty cutout section, only rebuilt when the camera moves
+    // into another section-sized cell or cutout meshes change.
+    static std::vector<CutoutSection> order;
+    static glm::ivec3 sortedCell(INT_MIN);
+    static uint64_t sortedGeneration = ~0ull;
+
+    const float cellSize = (float)Chunk::sectionHeight;
+    glm::ivec3 cell((int)std::floor((cameraPos.x + 0.5f) / cellSize),
+                    (int)std::floor((cameraPos.y + 0.5f) / cellSize),
+                    (int)std::floor((cameraPos.z + 0.5f) / cellSize));
+    if (cell != sortedCell || sortedGeneration != g_cutoutGeneration) {
+        order.clear();
+        for (auto& pair : manager.chunks) {
+            const ManagedChunk* mc = pair.second;
+            const ChunkMesh& mesh = mc->mesh;
+            if (mesh.cutoutGpuRange.count == 0) continue;
+            for (int s = 0; s + 1 < (int)mesh.cutoutSectionStarts.size(); s++) {
+                if (sectionVertexCount(mesh.cutoutSectionStarts, s) == 0) continue;
+                glm::vec3 center((mc->chunk.chunkX + 0.5f) * 16.0f - 0.5f,
+                                 (s + 0.5f) * Chunk::sectionHeight - 0.5f,
+                                 (mc->chunk.chunkZ + 0.5f) * 16.0f - 0.5f);
+                glm::vec3 d = center - cameraPos;
+                order.push_back({mc, s, glm::dot(d, d)});
+            }
+        }
+        std::sort(order.begin(), order.end(),
+                  [](const CutoutSection& a, const CutoutSection& b) { return a.distance2 > b.distance2; });
+        sortedCell = cell;
+        sortedGeneration = g_cutoutGeneration;
+        stats.cutoutSorts++;
+    }
+
+    g_drawFirsts.clear();
+    g_drawCounts.clear();
+    for (const CutoutSection& cs : order) {
+        auto it = g_visibleSectionMasks.find(cs.chunk);
+        if (it == g_visibleSectionMasks.end() || !(it->second & (1u << cs.section))) continue;
+
+        const ChunkMesh& mesh = cs.chunk->mesh;
+        GLint first = (GLint)(mesh.cutoutGpuRange.offset + mesh.cutoutSectionStarts[cs.section]);
+        GLsizei count = (GLsizei)sectionVertexCount(mesh.cutoutSectionStarts, cs.section);
+        stats.cutoutSections++;
+
+        // Consecutive sections that also sit next to each other in the buffer share a range.
+        if (!g_drawFirsts.empty() && g_drawFirsts.back() + g_drawCounts.back() == first) {
+            g_drawCounts.back() += count;
+            continue;
+        }
+        g_drawFirsts.push_back(first);
+        g_drawCounts.push_back(count);
+        stats.drawRanges++;
+    }
+    submitQueuedDraws(stats);
+}
+
+void uploadFarTiles(FarTerrain& farTerrain) {
+    for (auto& pair : farTerrain.tiles) {
+        FarTile* tile = pair.second;
+        if (!tile->needsUpload) continue;
+        uploadToArena(tile->gpuRange, tile->vertices);
+        tile->vertexCount = (uint32_t)(tile->vertices.size() / ChunkMesh::floatsPerVertex);
+        tile->vertices.clear();
+        tile->vertices.shrink_to_fit();
+        tile->needsUpload = false;
+    }
+}
+
+void releaseFarTile(FarTile& tile) {
+    g_arena.allocator.free(tile.gpuRange);
+}
+
+void drawFarTerrain(FarTerrain& farTerrain, const glm::mat4& viewProj, RenderStats& stats) {
+    static std::vector<FarTile*> candidates;
+    static CullBoxes tileBoxes;
+    static std::vector<uint8_t> tileVisible;
+
+    Frustum frustum = Frustum::fromMatrix(viewProj);
+    g_drawFirsts.clear();
+    g_drawCounts.clear();
+
+    const float tileSize = g_farTerrainSettings.tileChunks * 16.0f;
+    candidates.clear();
+    tileBoxes.clear();
+    for (auto& pair : farTerrain.tiles) {
+        FarTile* tile = pair.second;
+        if (tile->vertexCount == 0) continue;
+        glm::vec3 min(tile->tx * tileSize - 0.5f, tile->minY, tile->tz * tileSize - 0.5f);
+        glm::vec3 max(min.x + tileSize, tile->maxY, min.z + tileSize);
+        tileBoxes.add(min, max);
+        candidates.push_back(tile);
+    }
+    cullBoxes(frustum, tileBoxes, tileVisible);
+
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (!tileVisible[i]) {
+            stats.culledFarTiles++;
+            continue;
+        }
+        stats.visibleFarTiles++;
+        g_drawFirsts.push_back((GLint)candidates[i]->gpuRange.offset);
+        g_drawCounts.push_back((GLsizei)candidates[i]->vertexCount);
+        stats.drawRanges++;
+    }
+    submitQueuedDraws(stats);
+}
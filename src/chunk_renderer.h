@@ -0,0 +1,71 @@
+#pragma once
+#include "chunk.h"
+#include "frustum.h"
+#include "world.h"
+#include "vertex_arena.h"
+#include "far_terrain.h"
+#include <vector>
+
+struct MeshMemoryStats {
+    size_t gpuBytes = 0;      // vertex bytes of the loaded chunks' meshes in the arena
+    size_t cpuBytes = 0;      // retained CPU vertex copies (capacity)
+    size_t spareBytes = 0;    // idle buffers in the vertex buffer pool
+};
+
+struct RenderStats {
+    int visibleChunks = 0;
+    int culledChunks = 0;
+    int emptyChunks = 0; // no mesh uploaded yet, or nothing to draw
+    int visibleSections = 0;
+    int culledSections = 0;
+    int occludedSections = 0; // inside the frustum but not reachable from the camera section
+    int drawRanges = 0;       // vertex ranges submitted in the multi-draw
+    int drawCalls = 0;
+    int cutoutSections = 0;   // leaves sections drawn in the cutout pass
+    int cutoutSorts = 0;      // back-to-front re-sorts this frame (0 unless the camera changed section)
+    int visibleFarTiles = 0;
+    int culledFarTiles = 0;
+    uint64_t drawnVertices = 0; // submitted over all passes
+    MeshMemoryStats meshMemory;
+};
+
+// GL side of ChunkMesh: the core library only builds CPU vertex buffers. All chunk
+// meshes live in one shared vertex buffer, sub-allocated with VertexArenaAllocator.
+bool initChunkRenderer();
+void shutdownChunkRenderer();
+
+// After upload a mesh keeps only its vertex counts, section tables and arena ranges; the CPU
+// vertices go back to the vertex buffer pool. Turn this on to keep them in ChunkMesh::vertices
+// and cutoutVertices (for tools that read meshes back, e.g. an exporter).
+struct MeshRetentionSettings {
+    bool retainCpuVertices = false;
+};
+
+extern MeshRetentionSettings g_meshRetention;
+
+void uploadChunkMesh(ChunkMesh& mesh, CompletedMesh& completed);
+void releaseChunkMesh(ChunkMesh& mesh);
+ArenaStats getChunkArenaStats();
+size_t getChunkArenaBytes(); // live vertex bytes in the shared buffer (chunks and far tiles)
+MeshMemoryStats getMeshMemoryStats(ChunkManager& manager);
+
+extern bool g_occlusionCulling;
+
+// Frustum-culls every loaded chunk, then the sections of the chunks that survive.
+// With occlusion culling on, only sections reachable through air from the camera's
+// section (visibility.h) are drawn. All visible ranges go out in one glMultiDrawArrays.
+void drawVisibleChunks(ChunkManager& manager, const glm::mat4& viewProj, const glm::vec3& cameraPos,
+                       RenderStats& stats);
+
+// Leaves pass, after all opaque geometry (including far terrain): draws the cutout sections of
+// the chunks drawVisibleChunks found visible this frame, back to front. The order is cached and
+// only re-sorted when the camera enters another section-sized cell or cutout meshes change.
+void drawCutoutChunks(ChunkManager& manager, const glm::vec3& cameraPos, RenderStats& stats);
+
+// Far terrain tiles share the chunk arena and shader; uploads pending tile vertices.
+void uploadFarTiles(FarTerrain& farTerrain);
+void releaseFarTile(FarTile& tile);
+
+// Frustum-culls the far terrain tiles and draws the visible ones in one glMultiDrawArrays.
+// Call after drawVisibleChunks (it reuses its draw queue).
+void drawFarTerrain(FarTerrain& farTerrain, const glm::mat4& viewProj, RenderStats& stats);
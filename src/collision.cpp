@@ -0,0 +1,122 @@
+#include "collision.h"
+#include "world.h"
+#include <cmath>
+
+bool isBlockSolid(BlockType type) {
+    return blockInfo(type).solid;
+}
+
+bool collidesWithWorld(ChunkManager* world, const AABB& box) {
+    int minX = (int)floor(box.min.x);
+    int maxX = (int)ceil(box.max.x);
+    int minY = (int)floor(box.min.y);
+    int maxY = (int)ceil(box.max.y);
+    int minZ = (int)floor(box.min.z);
+    int maxZ = (int)ceil(box.max.z);
+
+    for (int x = minX; x <= maxX; x++) {
+        for (int y = minY; y <= maxY; y++) {
+            for (int z = minZ; z <= maxZ; z++) {
+                int cx = getChunkCoord((float)x);
+                int cz = getChunkCoord((float)z);
+
+                ManagedChunk* chunk = world->getChunk(cx, cz);
+                if (!chunk) continue;
+
+                int localX = x - cx * chunk->chunk.width;
+                int localZ = z - cz * chunk->chunk.depth;
+
+                if (localX < 0 || localX >= (int)chunk->chunk.width ||
+                    localZ < 0 || localZ >= (int)chunk->chunk.depth ||
+                    y < 0 || y >= (int)chunk->chunk.height) {
+                    continue;
+                }
+
+                BlockType blockType = chunk->chunk.getBlock(localX, y, localZ).type;
+
+                if (isBlockSolid(blockType)) {
+                    AABB blockBox(glm::vec3(x + 0.5f, y, z + 0.5f), 1.0f, 1.0f, 1.0f);
+                    if (box.intersects(blockBox)) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+bool raycastWorld(ChunkManager* world, glm::vec3 rayOrigin, glm::vec3 dir, float maxDist,
+                  glm::ivec3& outBlock, glm::ivec3& outNormal) {
+    if (!world) return false;
+    glm::vec3 rayDir = glm::normalize(dir);
+
+    glm::ivec3 mapPos = glm::ivec3(glm::floor(rayOrigin));
+    glm::vec3 deltaDist = glm::abs(glm::vec3(
+        1.0f / (rayDir.x == 0.0f ? 1e-6f : rayDir.x),
+        1.0f / (rayDir.y == 0.0f ? 1e-6f : rayDir.y),
+        1.0f / (rayDir.z == 0.0f ? 1e-6f : rayDir.z)));
+
+    glm::ivec3 step(
+        rayDir.x < 0 ? -1 : 1,
+        rayDir.y < 0 ? -1 : 1,
+        rayDir.z < 0 ? -1 : 1
+    );
+
+    glm::vec3 sideDist;
+    sideDist.x = ((rayDir.x < 0 ? (rayOrigin.x - (float)mapPos.x) : ((float)mapPos.x + 1.0f - rayOrigin.x))) * deltaDist.x;
+    sideDist.y = ((rayDir.y < 0 ? (rayOrigin.y - (float)mapPos.y) : ((float)mapPos.y + 1.0f - rayOrigin.y))) * deltaDist.y;
+    sideDist.z = ((rayDir.z < 0 ? (rayOrigin.z - (float)mapPos.z) : ((float)mapPos.z + 1.0f - rayOrigin.z))) * deltaDist.z;
+
+    glm::ivec3 hitNormal(0);
+    float dist = 0.0f;
+    const float maxDistEps = maxDist + 1.0f;
+
+    while (dist <= maxDistEps) {
+        int cx = getChunkCoord((float)mapPos.x);
+        int cz = getChunkCoord((float)mapPos.z);
+        ManagedChunk* mc = world->getChunk(cx, cz);
+        if (mc) {
+            int localX = mapPos.x - cx * (int)mc->chunk.width;
+            int localZ = mapPos.z - cz * (int)mc->chunk.depth;
+            if (localX >= 0 && localX < (int)mc->chunk.width &&
+                localZ >= 0 && localZ < (int)mc->chunk.depth &&
+                mapPos.y >= 0 && mapPos.y < (int)mc->chunk.height) {
+                BlockType bt = mc->chunk.getBlock(localX, mapPos.y, localZ).type;
+                if (bt != AIR) {
+                    outBlock = mapPos;
+                    outNormal = hitNormal;
+                    return true;
+                }
+            }
+        }
+
+        if (sideDist.x < sideDist.y) {
+            if (sideDist.x < sideDist.z) {
+                mapPos.x += step.x;
+                dist = sideDist.x;
+                sideDist.x += deltaDist.x;
+                hitNormal = glm::ivec3(-step.x, 0, 0);
+            } else {
+                mapPos.z += step.z;
+                dist = sideDist.z;
+                sideDist.z += deltaDist.z;
+                hitNormal = glm::ivec3(0, 0, -step.z);
+            }
+        } else {
+            if (sideDist.y < sideDist.z) {
+                mapPos.y += step.y;
+                dist = sideDist.y;
+                sideDist.y += deltaDist.y;
+                hitNormal = glm::ivec3(0, -step.y, 0);
+            } else {
+                mapPos.z += step.z;
+                dist = sideDist.z;
+                sideDist.z += deltaDist.z;
+                hitNormal = glm::ivec3(0, 0, -step.z);
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "block.h"
+
+struct ChunkManager;
+
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+
+    AABB(glm::vec3 center, float width, float height, float depth) {
+        min = center - glm::vec3(width/2.0f, 0.0f, depth/2.0f);
+        max = center + glm::vec3(width/2.0f, height, depth/2.0f);
+    }
+
+    bool intersects(const AABB& other) const {
+        return (min.x <= other.max.x && max.x >= other.min.x) &&
+               (min.y <= other.max.y && max.y >= other.min.y) &&
+               (min.z <= other.max.z && max.z >= other.min.z);
+    }
+};
+
+bool isBlockSolid(BlockType type);
+
+// True if any solid block in the loaded world overlaps box.
+bool collidesWithWorld(ChunkManager* world, const AABB& box);
+
+// DDA voxel walk from origin along dir; returns the first non-air block and the face normal it was entered through.
+bool raycastWorld(ChunkManager* world, glm::vec3 origin, glm::vec3 dir, float maxDist,
+                  glm::ivec3& outBlock, glm::ivec3& outNormal);
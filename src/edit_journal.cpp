@@ -0,0 +1,299 @@
+#include "edit_journal.h"
+#include "region_file.h"
+#include "region_storage.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+EditJournal g_editJournal;
+
+static const uint32_t BATCH_MAGIC = 0x424A5856; // "VXJB"
+static const size_t BATCH_HEADER = 12;           // magic, record count, CRC32 of the records
+static const std::chrono::milliseconds COMMIT_INTERVAL(50);
+static const std::chrono::seconds CHECKPOINT_INTERVAL(30);
+static const uint64_t CHECKPOINT_BYTES = 16u << 20;
+
+static_assert(sizeof(JournalEdit) == 12, "journal records are written as raw structs");
+
+EditJournal::~EditJournal() {
+    close();
+}
+
+std::string EditJournal::pathFor(uint32_t gen) const {
+    return directory + "/edits." + std::to_string(gen) + ".journal";
+}
+
+bool EditJournal::open(const std::string& dir) {
+    close();
+    directory = dir;
+
+    // Generations present on disk, oldest first.
+    std::vector<uint32_t> gens;
+    std::error_code ec;
+    for (auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        unsigned int gen;
+        char tail[16];
+        if (std::sscanf(name.c_str(), "edits.%u.%15s", &gen, tail) == 2 && std::strcmp(tail, "journal") == 0) {
+            gens.push_back(gen);
+        }
+    }
+    std::sort(gens.begin(), gens.end());
+
+    {
+        std::lock_guard<std::mutex> lock(replayMutex);
+        replayed.clear();
+    }
+    for (uint32_t gen : gens) replayFile(pathFor(gen));
+    if (!replayed.empty()) {
+        std::cout << "Replayed journaled edits for " << replayed.size() << " chunks" << std::endl;
+    }
+
+    retired = gens;
+    if (!openGeneration(gens.empty() ? 1 : gens.back() + 1)) return false;
+
+    stopping = false;
+    committer = std::thread(&EditJournal::commitLoop, this);
+    return true;
+}
+
+bool EditJournal::openGeneration(uint32_t gen) {
+    std::FILE* next = std::fopen(pathFor(gen).c_str(), "wb");
+    if (!next) {
+        std::cout << "Could not open edit journal " << pathFor(gen) << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file) std::fclose(file);
+    file = next;
+    generation = gen;
+    generationBytes = 0;
+    generationFailed = false;
+    return true;
+}
+
+void EditJournal::replayFile(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return;
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    std::vector<uint8_t> data(size > 0 ? (size_t)size : 0);
+    size_t got = std::fread(data.data(), 1, data.size(), f);
+    std::fclose(f);
+    data.resize(got);
+
+    std::lock_guard<std::mutex> lock(replayMutex);
+    size_t pos = 0;
+    while (data.size() - pos >= BATCH_HEADER) {
+        uint32_t header[3];
+        std::memcpy(header, data.data() + pos, BATCH_HEADER);
+        size_t bytes = (size_t)header[1] * sizeof(JournalEdit);
+        if (header[0] != BATCH_MAGIC || bytes > data.size() - pos - BATCH_HEADER) break;
+        const uint8_t* records = data.data() + pos + BATCH_HEADER;
+        // A torn batch is the tail of a write that never completed; nothing after it was committed.
+        if (crc32(records, bytes) != header[2]) break;
+
+        for (uint32_t i = 0; i < header[1]; i++) {
+            JournalEdit e;
+            std::memcpy(&e, records + i * sizeof(JournalEdit), sizeof(e));
+            replayed[{getChunkCoord((float)e.x), getChunkCoord((float)e.z)}].push_back(e);
+        }
+        pos += BATCH_HEADER + bytes;
+    }
+}
+
+void EditJournal::close() {
+    if (!committer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    committer.join();
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file) std::fclose(file);
+    file = nullptr;
+}
+
+void EditJournal::record(int worldX, int y, int worldZ, BlockType type, LogAxis axis) {
+    if (!file) return;
+    JournalEdit e;
+    e.x = worldX;
+    e.z = worldZ;
+    e.y = (uint16_t)y;
+    e.type = (uint8_t)type;
+    e.axis = (uint8_t)axis;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        buffer.push_back(e);
+        recordedCount++;
+    }
+    if (!hasEdits) {
+        hasEdits = true;
+        firstEditTime = std::chrono::steady_clock::now();
+    }
+    cv.notify_one();
+}
+
+void EditJournal::commitLoop() {
+    PROFILE_THREAD("Journal");
+    std::vector<JournalEdit> batch;
+    std::vector<uint8_t> bytes;
+    while (true) {
+        uint64_t taken;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopping || !buffer.empty(); });
+            if (buffer.empty()) return; // stopping and drained
+            // Group commit: let a burst of edits gather, then write them all with one fsync.
+            cv.wait_for(lock, COMMIT_INTERVAL, [this] { return stopping; });
+            batch.swap(buffer);
+            taken = recordedCount;
+        }
+
+        PROFILE_SCOPE("Journal commit");
+        uint32_t header[3] = { BATCH_MAGIC, (uint32_t)batch.size(), 0 };
+        size_t recordBytes = batch.size() * sizeof(JournalEdit);
+        bytes.resize(BATCH_HEADER + recordBytes);
+        std::memcpy(bytes.data() + BATCH_HEADER, batch.data(), recordBytes);
+        header[2] = crc32(bytes.data() + BATCH_HEADER, recordBytes);
+        std::memcpy(bytes.data(), header, BATCH_HEADER);
+        batch.clear();
+
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            ok = file && std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() &&
+                 std::fflush(file) == 0;
+#ifdef _WIN32
+            ok = ok && _commit(_fileno(file)) == 0;
+#else
+            ok = ok && fsync(fileno(file)) == 0;
+#endif
+        }
+        if (!ok) {
+            std::cout << "Failed to write edit journal" << std::endl;
+            generationFailed = true;
+        }
+        generationBytes += bytes.size();
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            committedCount = taken;
+            if (!ok) failedBatches++;
+        }
+        committedCv.notify_all();
+    }
+}
+
+bool EditJournal::waitCommitted(uint64_t failuresBefore) {
+    std::unique_lock<std::mutex> lock(mtx);
+    uint64_t target = recordedCount;
+    committedCv.wait(lock, [&] { return committedCount >= target; });
+    return failedBatches == failuresBefore;
+}
+
+bool EditJournal::takeReplayedEdits(int cx, int cz, std::vector<JournalEdit>& out) {
+    std::lock_guard<std::mutex> lock(replayMutex);
+    if (replayed.empty()) return false;
+    auto it = replayed.find({cx, cz});
+    if (it == replayed.end()) return false;
+    out = std::move(it->second);
+    replayed.erase(it);
+    return true;
+}
+
+size_t EditJournal::replayedChunks() {
+    std::lock_guard<std::mutex> lock(replayMutex);
+    return replayed.size();
+}
+
+bool EditJournal::checkpointDue() {
+    if (!file) return false;
+    if (generationFailed) return true;
+    if (!hasEdits) return false;
+    return generationBytes.load() > CHECKPOINT_BYTES ||
+           std::chrono::steady_clock::now() - firstEditTime > CHECKPOINT_INTERVAL;
+}
+
+void EditJournal::checkpoint(ChunkManager& manager) {
+    if (!file || !g_regionStorage.isOpen()) return;
+
+    // 1. New edits go to a fresh generation. Replayed edits that no chunk has picked up yet only
+    //    exist in the old files, so they are carried over to the front of the new one.
+    std::vector<uint32_t> toRemove;
+    uint64_t failures;
+    for (uint32_t gen : retired) {
+        if (std::filesystem::exists(pathFor(gen))) toRemove.push_back(gen); // left by a failed checkpoint
+    }
+    toRemove.push_back(generation);
+    if (!openGeneration(generation + 1)) return;
+    {
+        std::lock_guard<std::mutex> replayLock(replayMutex);
+        std::vector<JournalEdit> carried;
+        for (auto& pair : replayed) carried.insert(carried.end(), pair.second.begin(), pair.second.end());
+        std::lock_guard<std::mutex> lock(mtx);
+        buffer.insert(buffer.begin(), carried.begin(), carried.end());
+        recordedCount += carried.size();
+        failures = failedBatches;
+    }
+    cv.notify_one();
+    retired = toRemove;
+    hasEdits = false;
+
+    // 2. Everything edited so far goes to the region files; chunks unloaded earlier were queued
+    //    when they unloaded.
+    saveEditedChunks(manager);
+
+    // 3. Once those saves (and the carried-over edits) are on disk, the old generations are
+    //    redundant. If a save or a journal write failed they stay, and the next checkpoint
+    //    tries again.
+    g_regionStorage.whenWritten([this, toRemove, failures](bool ok) {
+        if (!ok) return;
+        if (!waitCommitted(failures)) {
+            std::cout << "Keeping old edit journals: a journal write failed" << std::endl;
+            return;
+        }
+        removeGenerations(toRemove);
+    });
+}
+
+void EditJournal::removeGenerations(std::vector<uint32_t> gens) {
+    for (uint32_t gen : gens) {
+        std::error_code ec;
+        std::filesystem::remove(pathFor(gen), ec);
+    }
+}
+
+void applyReplayedEdits(ChunkManager& manager, ManagedChunk* mc) {
+    std::vector<JournalEdit> edits;
+    if (!g_editJournal.takeReplayedEdits(mc->chunk.chunkX, mc->chunk.chunkZ, edits)) return;
+
+    Chunk& chunk = mc->chunk;
+    for (const JournalEdit& e : edits) {
+        int localX = e.x - chunk.chunkX * (int)chunk.width;
+        int localZ = e.z - chunk.chunkZ * (int)chunk.depth;
+        if (e.y >= chunk.height || e.type >= BLOCK_TYPE_COUNT) continue;
+        Block& b = chunk.getBlock(localX, e.y, localZ);
+        b.type = (BlockType)e.type;
+        b.axis = (LogAxis)e.axis;
+    }
+    mc->edited = true;
+    mc->meshDirty = true;
+
+    // Edits on the border change which faces the neighbours show.
+    const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    for (auto& o : offsets) {
+        ManagedChunk* n = manager.getChunk(chunk.chunkX + o[0], chunk.chunkZ + o[1]);
+        if (n) n->meshDirty = true;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "chunk.h"
+#include "world.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Write-ahead log of player block edits, so edits survive a crash between region saves.
+//
+// record() only appends to an in-memory list; a background thread group-commits everything
+// recorded since its last pass as one CRC-checked batch and fsyncs once per batch. The journal
+// is split into generations (edits.<n>.journal): a checkpoint starts a new generation, queues
+// region saves of every edited chunk and deletes the older generations once those saves are on
+// disk. On open, all generations are replayed (in order, stopping at a torn batch) into
+// per-chunk edit lists that are applied when each chunk next loads.
+struct JournalEdit {
+    int32_t x;
+    int32_t z;
+    uint16_t y;
+    uint8_t type;
+    uint8_t axis;
+};
+
+class EditJournal {
+public:
+    ~EditJournal();
+
+    // Replays the journal files in directory and starts a new generation.
+    bool open(const std::string& directory);
+    // Commits everything recorded so far and stops the commit thread. Files are kept; only a
+    // checkpoint removes them.
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    void record(int worldX, int y, int worldZ, BlockType type, LogAxis axis);
+
+    // Replayed edits for a chunk that has not been loaded since startup (removed from the list).
+    bool takeReplayedEdits(int cx, int cz, std::vector<JournalEdit>& out);
+    size_t replayedChunks();
+
+    // Due when the current generation is large, has held edits for a while, or a write to it
+    // failed (a torn batch hides every later batch in the file from replay).
+    bool checkpointDue();
+    void checkpoint(ChunkManager& manager);
+
+    uint64_t bytesWritten() const { return generationBytes.load(); }
+
+private:
+    typedef std::pair<int,int> Key;
+
+    std::string directory;
+    std::FILE* file = nullptr;     // swapped under fileMutex, which the commit thread holds while writing
+    std::mutex fileMutex;
+    uint32_t generation = 0;
+    std::vector<uint32_t> retired; // older generations waiting for their checkpoint to land
+    std::atomic<uint64_t> generationBytes{0};
+    std::atomic<bool> generationFailed{false};
+    std::chrono::steady_clock::time_point firstEditTime;
+    bool hasEdits = false;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::condition_variable committedCv;
+    std::vector<JournalEdit> buffer;
+    uint64_t recordedCount = 0;  // edits handed to record() (and carry-overs)
+    uint64_t committedCount = 0; // edits the commit thread has written (or failed to)
+    uint64_t failedBatches = 0;  // batches whose write or fsync failed
+    bool stopping = false;
+    std::thread committer;
+
+    std::mutex replayMutex;
+    std::unordered_map<Key, std::vector<JournalEdit>, pair_hash> replayed;
+
+    std::string pathFor(uint32_t gen) const;
+    bool openGeneration(uint32_t gen);
+    void replayFile(const std::string& path);
+    void commitLoop();
+    // Blocks until every edit recorded before the call has been written; false if any batch
+    // failed after failedBatches was failuresBefore, i.e. those edits may not be on disk.
+    bool waitCommitted(uint64_t failuresBefore);
+    void removeGenerations(std::vector<uint32_t> gens);
+};
+
+extern EditJournal g_editJournal;
+
+// Applies replayed edits to a chunk that just finished generating or loading and marks it edited.
+void applyReplayedEdits(ChunkManager& manager, ManagedChunk* mc);
@@ -0,0 +1,198 @@
+#include "far_terrain.h"
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+
+FarTerrainSettings g_farTerrainSettings;
+
+static const int CHUNK_SIZE = 16;
+static const int MAX_HEIGHT = 127;
+
+static void pushVertex(std::vector<float>& out, float x, float y, float z, uint32_t u, uint32_t v, uint32_t layer) {
+    out.push_back(x);
+    out.push_back(y);
+    out.push_back(z);
+    out.push_back(packVertexTexture(u, v, layer));
+}
+
+std::vector<float> buildFarTileVertices(FarTile& tile, int tileChunks) {
+    const int step = tile.step;
+    const int cells = tileChunks * CHUNK_SIZE / step;
+    const int cellsPerChunk = CHUNK_SIZE / step;
+    const int baseX = tile.tx * tileChunks * CHUNK_SIZE;
+    const int baseZ = tile.tz * tileChunks * CHUNK_SIZE;
+
+    // Corner heights and surface types, one extra row/column for the far edges.
+    std::vector<float> heights((cells + 1) * (cells + 1));
+    std::vector<uint8_t> mountain((cells + 1) * (cells + 1));
+    for (int j = 0; j <= cells; j++) {
+        for (int i = 0; i <= cells; i++) {
+            TerrainColumn col = sampleTerrainColumn(baseX + i * step, baseZ + j * step, MAX_HEIGHT);
+            heights[j * (cells + 1) + i] = col.terrainHeight + 0.5f;
+            mountain[j * (cells + 1) + i] = col.mountOffset > 0.0f;
+        }
+    }
+    auto h = [&](int i, int j) { return heights[j * (cells + 1) + i]; };
+
+    auto inHole = [&](int i, int j) {
+        if (i < 0 || j < 0 || i >= cells || j >= cells) return true;
+        int cx = tile.tx * tileChunks + i / cellsPerChunk;
+        int cz = tile.tz * tileChunks + j / cellsPerChunk;
+        return cx >= tile.holeX0 && cx <= tile.holeX1 && cz >= tile.holeZ0 && cz <= tile.holeZ1;
+    };
+    auto inTileHole = [&](int i, int j) {
+        if (i < 0 || j < 0 || i >= cells || j >= cells) return false;
+        return inHole(i, j);
+    };
+
+    const uint32_t grass = getTextureLayer(GRASS, 5);
+    const uint32_t dirt = getTextureLayer(DIRT, 5);
+    const float skirtDepth = (float)step * 2.0f;
+
+    std::vector<float> out;
+    tile.minY = 1e9f;
+    tile.maxY = -1e9f;
+
+    for (int j = 0; j < cells; j++) {
+        for (int i = 0; i < cells; i++) {
+            if (inTileHole(i, j)) continue;
+
+            // Block x spans [x - 0.5, x + 0.5], so grid corners sit half a block back.
+            float x0 = baseX + i * step - 0.5f, x1 = x0 + step;
+            float z0 = baseZ + j * step - 0.5f, z1 = z0 + step;
+            float h00 = h(i, j), h10 = h(i + 1, j), h01 = h(i, j + 1), h11 = h(i + 1, j + 1);
+            // Texture repeats once per block across the quad.
+            uint32_t layer = mountain[j * (cells + 1) + i] ? dirt : grass;
+            uint32_t n = (uint32_t)step;
+            uint32_t sv = 2 * n; // skirts are skirtDepth = 2 * step tall
+
+            // Counter-clockwise seen from above, like the TOP cube face.
+            pushVertex(out, x0, h00, z0, 0, 0, layer);
+            pushVertex(out, x1, h11, z1, n, n, layer);
+            pushVertex(out, x1, h10, z0, n, 0, layer);
+            pushVertex(out, x1, h11, z1, n, n, layer);
+            pushVertex(out, x0, h00, z0, 0, 0, layer);
+            pushVertex(out, x0, h01, z1, 0, n, layer);
+
+            float lo = std::min(std::min(h00, h10), std::min(h01, h11));
+            float hi = std::max(std::max(h00, h10), std::max(h01, h11));
+            tile.minY = std::min(tile.minY, lo - skirtDepth);
+            tile.maxY = std::max(tile.maxY, hi);
+
+            // Skirts hang down from edges that border a hole or another tile, facing outwards;
+            // a -> b runs right to left as seen from outside.
+            auto skirt = [&](float ax, float az, float ay, float bx, float bz, float by) {
+                pushVertex(out, bx, by, bz, n, sv, layer);
+                pushVertex(out, bx, by - skirtDepth, bz, n, 0, layer);
+                pushVertex(out, ax, ay, az, 0, sv, layer);
+                pushVertex(out, ax, ay - skirtDepth, az, 0, 0, layer);
+                pushVertex(out, ax, ay, az, 0, sv, layer);
+                pushVertex(out, bx, by - skirtDepth, bz, n, 0, layer);
+            };
+            if (inHole(i, j - 1)) skirt(x0, z0, h00, x1, z0, h10); // -Z
+            if (inHole(i, j + 1)) skirt(x1, z1, h11, x0, z1, h01); // +Z
+            if (inHole(i - 1, j)) skirt(x0, z1, h01, x0, z0, h00); // -X
+            if (inHole(i + 1, j)) skirt(x1, z0, h10, x1, z1, h11); // +X
+        }
+    }
+    return out;
+}
+
+void FarTerrain::update(const glm::vec3& pos, int voxelRadius) {
+    const FarTerrainSettings& s = g_farTerrainSettings;
+    if (!s.enabled) {
+        clear();
+        return;
+    }
+
+    int camChunkX = getChunkCoord(pos.x);
+    int camChunkZ = getChunkCoord(pos.z);
+
+    // Same square updateChunks loads (radius + 1 padding ring); those chunks have voxel meshes.
+    int voxelReach = voxelRadius + 1;
+    int holeX0 = camChunkX - voxelReach, holeX1 = camChunkX + voxelReach;
+    int holeZ0 = camChunkZ - voxelReach, holeZ1 = camChunkZ + voxelReach;
+    int farReach = voxelReach + s.ringChunks;
+
+    auto floorDiv = [](int a, int b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); };
+    int tx0 = floorDiv(camChunkX - farReach, s.tileChunks), tx1 = floorDiv(camChunkX + farReach, s.tileChunks);
+    int tz0 = floorDiv(camChunkZ - farReach, s.tileChunks), tz1 = floorDiv(camChunkZ + farReach, s.tileChunks);
+
+    std::set<std::pair<int,int>> wanted;
+    for (int tz = tz0; tz <= tz1; tz++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            int cx0 = tx * s.tileChunks, cx1 = cx0 + s.tileChunks - 1;
+            int cz0 = tz * s.tileChunks, cz1 = cz0 + s.tileChunks - 1;
+            bool coveredByVoxels = cx0 >= holeX0 && cx1 <= holeX1 && cz0 >= holeZ0 && cz1 <= holeZ1;
+            if (!coveredByVoxels) wanted.insert({tx, tz});
+        }
+    }
+
+    std::vector<std::pair<int,int>> toRemove;
+    for (auto& pair : tiles) {
+        if (wanted.find(pair.first) == wanted.end()) toRemove.push_back(pair.first);
+    }
+    for (auto& key : toRemove) {
+        auto it = tiles.find(key);
+        if (onRemove) onRemove(it->second);
+        delete it->second;
+        tiles.erase(it);
+    }
+
+    // Tiles whose spacing or hole changed, rebuilt nearest first so the ring fills in from the
+    // voxel edge outwards; the rest keep their old geometry until a later update gets to them.
+    struct Rebuild {
+        int dist;
+        FarTile* tile;
+        int step, hx0, hz0, hx1, hz1;
+    };
+    std::vector<Rebuild> pending;
+    for (auto& key : wanted) {
+        FarTile*& tile = tiles[key];
+        if (!tile) {
+            tile = new FarTile();
+            tile->tx = key.first;
+            tile->tz = key.second;
+        }
+
+        int cx0 = tile->tx * s.tileChunks, cz0 = tile->tz * s.tileChunks;
+        int cx1 = cx0 + s.tileChunks - 1, cz1 = cz0 + s.tileChunks - 1;
+        int dist = std::max(std::max(cx0 - camChunkX, camChunkX - cx1),
+                            std::max(cz0 - camChunkZ, camChunkZ - cz1));
+        int step = (dist - voxelReach < s.ringChunks / 2) ? 4 : 8;
+
+        // Only the part of the voxel square that overlaps this tile matters.
+        int hx0 = std::max(holeX0, cx0), hx1 = std::min(holeX1, cx1);
+        int hz0 = std::max(holeZ0, cz0), hz1 = std::min(holeZ1, cz1);
+        if (hx0 > hx1 || hz0 > hz1) { hx0 = hz0 = 1; hx1 = hz1 = 0; }
+
+        if (tile->step != step || tile->holeX0 != hx0 || tile->holeX1 != hx1 ||
+            tile->holeZ0 != hz0 || tile->holeZ1 != hz1) {
+            pending.push_back({dist, tile, step, hx0, hz0, hx1, hz1});
+        }
+    }
+
+    std::sort(pending.begin(), pending.end(),
+              [](const Rebuild& a, const Rebuild& b) { return a.dist < b.dist; });
+    if ((int)pending.size() > s.maxBuildsPerFrame) pending.resize(s.maxBuildsPerFrame);
+    for (Rebuild& r : pending) {
+        FarTile* tile = r.tile;
+        tile->step = r.step;
+        tile->holeX0 = r.hx0; tile->holeX1 = r.hx1;
+        tile->holeZ0 = r.hz0; tile->holeZ1 = r.hz1;
+        tile->vertices = buildFarTileVertices(*tile, s.tileChunks);
+        tile->needsUpload = true;
+    }
+}
+
+void FarTerrain::clear() {
+    for (auto& pair : tiles) {
+        if (onRemove) onRemove(pair.second);
+        delete pair.second;
+    }
+    tiles.clear();
+}
+
+FarTerrain::~FarTerrain() {
+    clear();
+}
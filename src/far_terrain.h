@@ -0,0 +1,49 @@
+#pragma once
+#include "world.h"
+#include "vertex_arena.h"
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Heightmap-only terrain for a ring of chunks outside the voxel radius. Built straight from
+// sampleTerrainColumn, no block data: each tile is a grid of textured quads (same vertex layout
+// as ChunkMesh) with skirts along its edges to hide cracks between sample spacings.
+struct FarTerrainSettings {
+    bool enabled = true;
+    int ringChunks = 32;         // how far past the voxel radius the far terrain reaches
+    int tileChunks = 4;          // tile edge length in chunks
+    int maxBuildsPerFrame = 4;   // tiles (re)built per update, keeps the cost off any one frame
+};
+
+extern FarTerrainSettings g_farTerrainSettings;
+
+struct FarTile {
+    int tx, tz;
+    int step = 0;                // sample spacing in blocks
+    // Voxel chunk range (inclusive) cut out of this tile when it was built; empty when x0 > x1
+    int holeX0 = 1, holeZ0 = 1, holeX1 = 0, holeZ1 = 0;
+    float minY = 0.0f, maxY = 0.0f;
+
+    std::vector<float> vertices; // waiting for upload, cleared by the renderer
+    bool needsUpload = false;
+    ArenaRange gpuRange;          // rounded up to the arena granularity
+    uint32_t vertexCount = 0;     // vertices actually in gpuRange
+};
+
+struct FarTerrain {
+    std::unordered_map<std::pair<int,int>, FarTile*, pair_hash> tiles;
+
+    // Called just before a tile is deleted, e.g. so the renderer can free its GPU range.
+    std::function<void(FarTile*)> onRemove;
+
+    // Adds/removes tiles around the camera and rebuilds the ones whose hole or spacing changed.
+    // voxelRadius is the radius passed to updateChunks.
+    void update(const glm::vec3& pos, int voxelRadius);
+    void clear();
+
+    ~FarTerrain();
+};
+
+// Vertices for tile (tx, tz) sampled every `step` blocks, skipping chunks inside the hole.
+std::vector<float> buildFarTileVertices(FarTile& tile, int tileChunks);
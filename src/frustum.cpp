@@ -0,0 +1,95 @@
+#include "frustum.h"
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_SSE 1
+#endif
+
+Frustum Frustum::fromMatrix(const glm::mat4& m) {
+    // Gribb/Hartmann: rows of the combined matrix (glm is column-major, m[col][row])
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum f;
+    f.planes[0] = row3 + row0;
+    f.planes[1] = row3 - row0;
+    f.planes[2] = row3 + row1;
+    f.planes[3] = row3 - row1;
+    f.planes[4] = row3 + row2;
+    f.planes[5] = row3 - row2;
+
+    for (auto& p : f.planes) {
+        float len = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        if (len > 0.0f) p = p / len;
+    }
+    return f;
+}
+
+bool Frustum::intersectsBox(const glm::vec3& min, const glm::vec3& max) const {
+    for (const auto& p : planes) {
+        // Farthest corner along the plane normal; if even that is behind, the box is outside.
+        float px = p.x > 0.0f ? max.x : min.x;
+        float py = p.y > 0.0f ? max.y : min.y;
+        float pz = p.z > 0.0f ? max.z : min.z;
+        if (p.x * px + p.y * py + p.z * pz + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+void CullBoxes::clear() {
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+}
+
+void CullBoxes::add(const glm::vec3& min, const glm::vec3& max) {
+    minX.push_back(min.x); minY.push_back(min.y); minZ.push_back(min.z);
+    maxX.push_back(max.x); maxY.push_back(max.y); maxZ.push_back(max.z);
+}
+
+void cullBoxes(const Frustum& frustum, const CullBoxes& boxes, std::vector<uint8_t>& visible) {
+    const size_t n = boxes.size();
+    visible.assign(n, 1);
+
+    // Per plane, pick which bound array supplies the farthest corner on each axis.
+    const float* cornerX[6];
+    const float* cornerY[6];
+    const float* cornerZ[6];
+    for (int p = 0; p < 6; p++) {
+        const glm::vec4& pl = frustum.planes[p];
+        cornerX[p] = pl.x > 0.0f ? boxes.maxX.data() : boxes.minX.data();
+        cornerY[p] = pl.y > 0.0f ? boxes.maxY.data() : boxes.minY.data();
+        cornerZ[p] = pl.z > 0.0f ? boxes.maxZ.data() : boxes.minZ.data();
+    }
+
+    size_t i = 0;
+#ifdef FRUSTUM_SSE
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for (int p = 0; p < 6; p++) {
+            const glm::vec4& pl = frustum.planes[p];
+            __m128 d = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cornerX[p] + i), _mm_set1_ps(pl.x)),
+                           _mm_mul_ps(_mm_loadu_ps(cornerY[p] + i), _mm_set1_ps(pl.y))),
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cornerZ[p] + i), _mm_set1_ps(pl.z)),
+                           _mm_set1_ps(pl.w)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+        }
+        int mask = _mm_movemask_ps(inside);
+        visible[i + 0] = (mask >> 0) & 1;
+        visible[i + 1] = (mask >> 1) & 1;
+        visible[i + 2] = (mask >> 2) & 1;
+        visible[i + 3] = (mask >> 3) & 1;
+    }
+#endif
+    for (; i < n; i++) {
+        for (int p = 0; p < 6; p++) {
+            const glm::vec4& pl = frustum.planes[p];
+            float d = cornerX[p][i] * pl.x + cornerY[p][i] * pl.y + cornerZ[p][i] * pl.z + pl.w;
+            if (d < 0.0f) { visible[i] = 0; break; }
+        }
+    }
+}
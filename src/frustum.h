@@ -0,0 +1,26 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Six planes (left, right, bottom, top, near, far) with inward-facing normals,
+// extracted from a projection * view matrix.
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum fromMatrix(const glm::mat4& viewProj);
+    bool intersectsBox(const glm::vec3& min, const glm::vec3& max) const;
+};
+
+// Structure-of-arrays box list so the plane test can run over 4 boxes per instruction.
+struct CullBoxes {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    void clear();
+    void add(const glm::vec3& min, const glm::vec3& max);
+    size_t size() const { return minX.size(); }
+};
+
+// visible[i] = 1 if box i is at least partially inside the frustum
+void cullBoxes(const Frustum& frustum, const CullBoxes& boxes, std::vector<uint8_t>& visible);
@@ -0,0 +1,63 @@
+#include "lod.h"
+#include <algorithm>
+#include <cstdlib>
+
+LodSettings g_lodSettings;
+
+int lodScaleForChunk(int cx, int cz, int camChunkX, int camChunkZ) {
+    if (!g_lodSettings.enabled) return 1;
+
+    int dist = std::max(std::abs(cx - camChunkX), std::abs(cz - camChunkZ));
+    int scale = 1;
+    for (int level = 0; level < LOD_MAX_LEVEL; level++) {
+        if (dist < g_lodSettings.levelDistance[level]) break;
+        scale *= 2;
+    }
+    return scale;
+}
+
+void downsampleChunk(const Chunk& src, int scale, Chunk& out) {
+    int w = src.width / scale;
+    int d = src.depth / scale;
+    int h = src.height / scale;
+    out = Chunk(src.chunkX, src.chunkZ, w, d, h);
+    out.scale = src.scale * scale;
+
+    const int cellVolume = scale * scale * scale;
+    int counts[BLOCK_TYPE_COUNT];
+
+    for (int z = 0; z < d; z++) {
+        for (int x = 0; x < w; x++) {
+            for (int y = 0; y < h; y++) {
+                int solid = 0;
+                int topLayer = -1;
+                for (int dz = 0; dz < scale; dz++) {
+                    for (int dx = 0; dx < scale; dx++) {
+                        const Block* col = &src.blocks[src.index(x * scale + dx, y * scale, z * scale + dz)];
+                        for (int dy = 0; dy < scale; dy++) {
+                            if (col[dy].type == AIR) continue;
+                            solid++;
+                            topLayer = std::max(topLayer, dy);
+                        }
+                    }
+                }
+                if (solid * 2 < cellVolume) continue;
+
+                std::fill(counts, counts + BLOCK_TYPE_COUNT, 0);
+                Block picked;
+                int best = 0;
+                for (int dz = 0; dz < scale; dz++) {
+                    for (int dx = 0; dx < scale; dx++) {
+                        const Block& b = src.blocks[src.index(x * scale + dx, y * scale + topLayer, z * scale + dz)];
+                        if (b.type == AIR) continue;
+                        if (++counts[b.type] > best) {
+                            best = counts[b.type];
+                            picked = b;
+                        }
+                    }
+                }
+                out.getBlock(x, y, z) = picked;
+            }
+        }
+    }
+}
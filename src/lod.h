@@ -0,0 +1,22 @@
+#pragma once
+#include "chunk.h"
+
+// Distance-based level of detail for far chunks. A chunk at LOD level n is meshed from a copy of
+// its blocks downsampled 2^n times along every axis (scale 2, 4 or 8), with the same mesher.
+struct LodSettings {
+    bool enabled = true;
+    // Chebyshev chunk distance from the camera's chunk at which each coarser level starts.
+    int levelDistance[3] = { 6, 12, 20 };
+};
+
+extern LodSettings g_lodSettings;
+
+const int LOD_MAX_LEVEL = 3;
+
+// World blocks per stored block for the chunk at (cx, cz) seen from the camera chunk.
+int lodScaleForChunk(int cx, int cz, int camChunkX, int camChunkZ);
+
+// Builds a copy of src with every scale^3 cell collapsed into one block. A cell is solid when at
+// least half of it is non-air; its type is the most common one in its topmost non-air layer, so
+// grass/snow tops survive instead of being outvoted by the dirt and stone underneath.
+void downsampleChunk(const Chunk& src, int scale, Chunk& out);
@@ -6,12 +6,14 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdlib>
 #include <limits>
 #include <csignal>
 #include <fstream>
 #include <chrono>
 #include <iomanip>
 #include <exception>
+#include <algorithm>
 
 #include "imgui/imgui.h"
 #include "imgui/backends/imgui_impl_glfw.h"
@@ -21,6 +23,16 @@
 #include "renderer.h"
 #include "world.h"
 #include "chunk.h"
+#include "chunk_renderer.h"
+#include "lod.h"
+#include "far_terrain.h"
+#include "region_storage.h"
+#include "edit_journal.h"
+#include "chunk_cache.h"
+#include "memory_budget.h"
+#include "profiler.h"
+#include "profiler_window.h"
+#include "perf_overlay.h"
 
 Player* g_player = nullptr;
 
@@ -33,9 +45,14 @@ bool g_showSettings = false;
 
 bool g_vsyncEnabled = false;
 int g_fpsLimit = 0;
+int g_renderDistance = 8;
 int g_selectedResolution = 0;
 
 bool g_debugHitbox = false;
+bool g_showProfiler = false;
+bool g_showPerfOverlay = false;
+std::string g_tracePath = "trace.json";
+const int TRACE_KEY_FRAMES = 120;
 
 void WriteCrashLog(const char* reason)
 {
@@ -187,6 +204,19 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
             std::cout << "Movement mode: " << (g_player->mode == MovementMode::FLY ? "FLY" : "NORMAL") << std::endl;
         }
 
+        if (key == GLFW_KEY_F2) {
+            g_showPerfOverlay = !g_showPerfOverlay;
+        }
+
+        if (key == GLFW_KEY_F3) {
+            g_showProfiler = !g_showProfiler;
+        }
+
+        if (key == GLFW_KEY_F4 && !g_profiler.capturingTrace()) {
+            g_profiler.captureTrace(TRACE_KEY_FRAMES, g_tracePath);
+            std::cout << "Capturing " << TRACE_KEY_FRAMES << " frames to " << g_tracePath << std::endl;
+        }
+
         if (key == GLFW_KEY_F11) {
             static bool isFullscreen = false;
             static int windowedX, windowedY, windowedWidth, windowedHeight;
@@ -319,6 +349,72 @@ void renderSettingsMenu(GLFWwindow* window) {
         g_fpsLimit = fpsValues[fpsIndex];
     }
 
+    ImGui::Spacing();
+
+    ImGui::Checkbox("Occlusion Culling", &g_occlusionCulling);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(?)");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Skip chunk sections that cannot be seen through caves or open air from the camera");
+    }
+
+    ImGui::Spacing();
+
+    ImGui::Text("Render Distance:");
+    ImGui::SliderInt("##RenderDistance", &g_renderDistance, 4, 64);
+
+    ImGui::Checkbox("Far Chunk LOD", &g_lodSettings.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(?)");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Mesh distant chunks from 2x/4x/8x downsampled blocks");
+    }
+    if (g_lodSettings.enabled) {
+        ImGui::SliderInt3("LOD Distances", g_lodSettings.levelDistance, 2, 64);
+    }
+
+    ImGui::Checkbox("Far Terrain", &g_farTerrainSettings.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(?)");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Draw a heightmap of the terrain beyond the render distance");
+    }
+    if (g_farTerrainSettings.enabled) {
+        ImGui::SliderInt("Far Terrain Ring", &g_farTerrainSettings.ringChunks, 8, 128);
+    }
+
+    ImGui::Text("Chunk Cache (MB):");
+    ImGui::SameLine();
+    ImGui::TextDisabled("(?)");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Compressed copies of recently unloaded chunks, so walking back does not regenerate them");
+    }
+    ImGui::SliderInt("##ChunkCache", &g_chunkCacheSettings.budgetMB, 0, 512);
+
+    ImGui::Checkbox("Memory Budget", &g_memoryBudget.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(?)");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Over budget, drop cached chunks first, then load a smaller radius until memory fits");
+    }
+    if (g_memoryBudget.enabled) {
+        ImGui::SliderInt("Budget (MB)", &g_memoryBudget.budgetMB, 256, 8192);
+    }
+
+    ImGui::Checkbox("Keep Mesh Vertices", &g_meshRetention.retainCpuVertices);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(?)");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Keep a CPU copy of every uploaded chunk mesh (for debugging); applies as chunks remesh");
+    }
+
+    ImGui::Checkbox("Save Edits Only", &g_saveSettings.editDeltas);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(?)");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Store only changed blocks and regenerate the rest of a saved chunk from the seed");
+    }
+
     ImGui::Spacing();
     ImGui::Spacing();
 
@@ -379,16 +475,24 @@ void renderSettingsMenu(GLFWwindow* window) {
 int main(int argc, char* argv[]) {
     InstallCrashHandlers();
 
-    unsigned int seed = 0;
-    if (argc > 1) {
-        try {
-            seed = std::stoul(argv[1]);
-        } catch (const std::exception& e) {
-            std::cerr << "Invalid seed provided, using random seed" << std::endl;
-            seed = static_cast<unsigned int>(std::time(nullptr));
+    // Usage: app [seed] [--trace <frames>] [--trace-out <file>]
+    unsigned int seed = static_cast<unsigned int>(std::time(nullptr));
+    int traceFrames = 0;
+    bool seedGiven = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) {
+            traceFrames = std::atoi(argv[++i]);
+        } else if (arg == "--trace-out" && i + 1 < argc) {
+            g_tracePath = argv[++i];
+        } else if (!seedGiven) {
+            seedGiven = true;
+            try {
+                seed = std::stoul(arg);
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid seed provided, using random seed" << std::endl;
+            }
         }
-    } else {
-        seed = static_cast<unsigned int>(std::time(nullptr));
     }
 
     if (!glfwInit()) {
@@ -453,13 +557,28 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
+    if (!initChunkRenderer()) {
+        std::cout << "Failed to initialize chunk renderer" << std::endl;
+        return -1;
+    }
+
     initPerlin(seed);
+    // Player edits persist per seed; everything else is regenerated from noise.
+    std::string saveDirectory = "saves/world_" + std::to_string(seed);
+    g_regionStorage.open(saveDirectory);
+    // Replays edits a crash kept out of the region files; they are applied as their chunks load.
+    if (g_regionStorage.isOpen()) g_editJournal.open(saveDirectory);
     ChunkManager chunkManager;
+    chunkManager.onRemove = [](ManagedChunk* mc) { releaseChunkMesh(mc->mesh); };
+    FarTerrain farTerrain;
+    farTerrain.onRemove = [](FarTile* tile) { releaseFarTile(*tile); };
     player.setActiveWorld(&chunkManager);
     player.setRaycastOriginOffset(glm::vec3(0.5f, 0.5f, 0.5f));
 
-    int renderDistance = 8;
-    updateChunks(chunkManager, player.position, renderDistance, renderer.getShaderProgram());
+    // Registered before the workers start, so the main thread is listed first in the profiler.
+    PROFILE_THREAD("Main");
+    if (traceFrames > 0) g_profiler.captureTrace(traceFrames, g_tracePath);
+    updateChunks(chunkManager, player.position, g_renderDistance, renderer.getShaderProgram());
 
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
@@ -467,12 +586,17 @@ int main(int argc, char* argv[]) {
     int frames = 0;
     float frameTimeAccumulator = 0.0f;
 
+    RenderStats renderStats;
+
     int lastCamChunkX = getChunkCoord(player.position.x);
     int lastCamChunkZ = getChunkCoord(player.position.z);
 
     std::cout << "Controls:" << std::endl;
     std::cout << "  WASD - Move" << std::endl;
     std::cout << "  Space - Jump (Normal mode) / Up (Fly mode)" << std::endl;
+    std::cout << "  F2 - Performance overlay" << std::endl;
+    std::cout << "  F3 - Profiler" << std::endl;
+    std::cout << "  F4 - Capture a trace of the next " << TRACE_KEY_FRAMES << " frames" << std::endl;
 
     while (!glfwWindowShouldClose(window)) {
         float currentFrame = glfwGetTime();
@@ -503,6 +627,7 @@ int main(int argc, char* argv[]) {
         }
 
         if (!g_showPauseMenu) {
+            PROFILE_SCOPE("Player update");
             player.processKeyboard(window, deltaTime, &chunkManager);
             player.update(deltaTime, &chunkManager);
         }
@@ -518,68 +643,100 @@ int main(int argc, char* argv[]) {
             glm::radians(70.0f),
             safeAspect,
             0.1f,
-            500.0f
-        );
-
-        glUseProgram(renderer.getShaderProgram());
-        glUniformMatrix4fv(
-            glGetUniformLocation(renderer.getShaderProgram(), "view"),
-            1, GL_FALSE, glm::value_ptr(view)
-        );
-        glUniformMatrix4fv(
-            glGetUniformLocation(renderer.getShaderProgram(), "projection"),
-            1, GL_FALSE, glm::value_ptr(projection)
+            std::max(500.0f, (g_renderDistance + 2 +
+                              (g_farTerrainSettings.enabled ? g_farTerrainSettings.ringChunks + g_farTerrainSettings.tileChunks : 0))
+                             * 16.0f * 1.5f)
         );
 
-        updateChunks(chunkManager, player.position, renderDistance, renderer.getShaderProgram());
-
-        while (true) {
-            CompletedMesh m;
-            if (!g_completedMeshes.try_pop(m)) break;
-            ManagedChunk* mc = chunkManager.getChunk(m.cx, m.cz);
-            if (!mc) continue;
-            mc->mesh.uploadToGPU(m.vertices);
-            mc->meshDirty = false;
-            mc->meshUploaded = true;
-            mc->inMeshQueue = false;
+        int loadRadius;
+        {
+            PROFILE_SCOPE("Memory budget");
+            g_chunkCache.setBudget((size_t)std::max(g_chunkCacheSettings.budgetMB, 0) << 20);
+            MemoryUsage memory = measureWorldMemory(chunkManager);
+            memory.bytes[MEM_GPU_MESHES] = getChunkArenaBytes();
+            loadRadius = g_memoryGovernor.update(memory, g_renderDistance, chunkManager.chunks.size());
         }
 
-        glBindTexture(GL_TEXTURE_2D, renderer.getAtlasTexture());
-        for (auto& pair : chunkManager.chunks) {
-            ManagedChunk* mc = pair.second;
-
-            glm::mat4 model = glm::mat4(1.0f);
-            glUniformMatrix4fv(
-                glGetUniformLocation(renderer.getShaderProgram(),
-                "model"),
-1, GL_FALSE, glm::value_ptr(model)
-                );
-            mc->mesh.draw();
+        updateChunks(chunkManager, player.position, loadRadius, renderer.getShaderProgram());
+        g_regionStorage.prefetchAhead(player.position, player.velocity, loadRadius);
+        if (g_editJournal.checkpointDue()) g_editJournal.checkpoint(chunkManager);
+        {
+            PROFILE_SCOPE("Far terrain");
+            farTerrain.update(player.position, loadRadius);
+            uploadFarTiles(farTerrain);
         }
 
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
-
-        if (g_showPauseMenu) {
-            if (g_showSettings) {
-                renderSettingsMenu(window);
-            } else {
-                renderPauseMenu(window);
+        {
+            PROFILE_SCOPE("Upload meshes");
+            while (true) {
+                CompletedMesh m;
+                if (!g_completedMeshes.try_pop(m)) break;
+                ManagedChunk* mc = chunkManager.getChunk(m.cx, m.cz);
+                if (!mc) continue;
+                uploadChunkMesh(mc->mesh, m);
+                mc->meshDirty = false;
+                mc->meshUploaded = true;
+                mc->inMeshQueue = false;
             }
         }
 
-        if (!g_showPauseMenu) {
-            player.renderHUD();
+        {
+            PROFILE_SCOPE("Draw");
+            renderer.beginChunkPass(view, projection);
+            {
+                PROFILE_SCOPE("Draw chunks");
+                drawVisibleChunks(chunkManager, projection * view, player.getCameraPosition(), renderStats);
+            }
+            {
+                PROFILE_SCOPE("Draw far terrain");
+                drawFarTerrain(farTerrain, projection * view, renderStats);
+            }
+            PROFILE_SCOPE("Draw cutout");
+            renderer.beginCutoutPass();
+            drawCutoutChunks(chunkManager, player.getCameraPosition(), renderStats);
+            renderer.endCutoutPass();
         }
 
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            PROFILE_SCOPE("ImGui");
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+
+            if (g_showPauseMenu) {
+                if (g_showSettings) {
+                    renderSettingsMenu(window);
+                } else {
+                    renderPauseMenu(window);
+                }
+            }
 
-        glfwSwapBuffers(window);
+            if (!g_showPauseMenu) {
+                player.renderHUD();
+            }
+            if (g_showPerfOverlay) renderPerfOverlay(chunkManager, renderStats);
+            if (g_showProfiler) renderProfilerWindow(&g_showProfiler);
+
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+
+        {
+            PROFILE_SCOPE("Swap buffers");
+            glfwSwapBuffers(window);
+        }
         glfwPollEvents();
+        g_profiler.endFrame();
     }
 
+    // Saves every edited chunk; the journal files go once those saves are on disk.
+    if (g_editJournal.isOpen()) g_editJournal.checkpoint(chunkManager);
+    else saveEditedChunks(chunkManager);
+    g_regionStorage.close();
+    g_editJournal.close();
+
+    shutdownChunkRenderer();
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
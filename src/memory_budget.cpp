@@ -0,0 +1,113 @@
+#include "memory_budget.h"
+#include "chunk_cache.h"
+#include "region_storage.h"
+#include <algorithm>
+#include <functional>
+
+MemoryBudgetSettings g_memoryBudget;
+MemoryGovernor g_memoryGovernor;
+
+// Block array of a chunk at the default dimensions, for chunks that are only counted
+static const size_t CHUNK_BLOCK_BYTES = 16 * 16 * 128 * sizeof(Block);
+static const std::chrono::milliseconds SHRINK_INTERVAL(500);
+static const std::chrono::milliseconds GROW_INTERVAL(2000);
+
+const char* memorySubsystemName(MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MEM_BLOCKS: return "Blocks";
+        case MEM_CPU_MESHES: return "CPU meshes";
+        case MEM_GPU_MESHES: return "GPU meshes";
+        case MEM_JOB_QUEUES: return "Job queues";
+        case MEM_CACHES: return "Caches";
+        default: return "?";
+    }
+}
+
+size_t MemoryUsage::total() const {
+    size_t sum = 0;
+    for (size_t b : bytes) sum += b;
+    return sum;
+}
+
+MemoryUsage measureWorldMemory(ChunkManager& manager) {
+    MemoryUsage u;
+    for (auto& pair : manager.chunks) {
+        const ManagedChunk* mc = pair.second;
+        const ChunkMesh& mesh = mc->mesh;
+        u.bytes[MEM_BLOCKS] += mc->chunk.blocks.capacity() * sizeof(Block);
+        u.bytes[MEM_CPU_MESHES] += (mesh.vertices.capacity() + mesh.cutoutVertices.capacity()) * sizeof(float) +
+                                   (mesh.sectionStarts.capacity() + mesh.cutoutSectionStarts.capacity()) * sizeof(int) +
+                                   mesh.sectionConnectivity.capacity() * sizeof(uint64_t);
+    }
+    u.bytes[MEM_BLOCKS] += manager.pool.stats().idle * CHUNK_BLOCK_BYTES;
+
+    // Each queued save holds a snapshot of the whole chunk.
+    u.bytes[MEM_JOB_QUEUES] = g_completedMeshes.bytes() + queuedJobs() * sizeof(std::function<void()>) +
+                              g_regionStorage.pendingWrites() * CHUNK_BLOCK_BYTES;
+    u.bytes[MEM_CACHES] = g_chunkCache.stats().bytes + g_vertexBuffers.spareBytes();
+    return u;
+}
+
+void MemoryGovernor::setCacheLimit(size_t limit) {
+    cacheLimit = limit;
+    g_chunkCache.setByteLimit(limit);
+}
+
+// Chunks updateChunks keeps loaded for a radius (it pads the radius by one ring).
+static size_t chunksForRadius(int radius) {
+    size_t side = 2 * (size_t)(radius + 1) + 1;
+    return side * side;
+}
+
+int MemoryGovernor::update(const MemoryUsage& usage, int requestedRadius, size_t loadedChunks) {
+    measured = usage;
+    size_t budget = (size_t)std::max(g_memoryBudget.budgetMB, 0) << 20;
+    if (!g_memoryBudget.enabled) {
+        if (cacheLimit != SIZE_MAX) setCacheLimit(SIZE_MAX);
+        radiusCap = requestedRadius;
+        limited = false;
+        return requestedRadius;
+    }
+
+    if (radiusCap < 0 || radiusCap > requestedRadius || !limited) radiusCap = requestedRadius;
+    auto now = std::chrono::steady_clock::now();
+    size_t total = usage.total();
+    size_t comfortable = budget / 10 * 9;
+
+    if (total > budget) {
+        // Caches first: they refill on their own and losing them only costs regeneration time.
+        size_t excess = total - budget;
+        size_t cached = usage.bytes[MEM_CACHES];
+        if (cached > 0) {
+            g_vertexBuffers.trim();
+            setCacheLimit(std::min(cacheLimit, cached > excess ? cached - excess : 0));
+            if (cached >= excess) return radiusCap;
+        }
+        if (radiusCap > MIN_RADIUS && now - lastChange >= SHRINK_INTERVAL) {
+            radiusCap--;
+            limited = true;
+            lastChange = now;
+        }
+    } else if (total < comfortable && now - lastChange >= GROW_INTERVAL) {
+        if (radiusCap < requestedRadius) {
+            // Grow only as far as the extra chunks should fit, going by what a loaded chunk
+            // costs now (at least its block array).
+            size_t resident = usage.bytes[MEM_BLOCKS] + usage.bytes[MEM_CPU_MESHES] + usage.bytes[MEM_GPU_MESHES];
+            size_t perChunk = std::max(CHUNK_BLOCK_BYTES, loadedChunks ? resident / loadedChunks : 0);
+            int radius = radiusCap;
+            while (radius < requestedRadius &&
+                   total + perChunk * (chunksForRadius(radius + 1) - std::min(loadedChunks, chunksForRadius(radius + 1))) < comfortable) {
+                radius++;
+            }
+            if (radius != radiusCap) {
+                radiusCap = radius;
+                lastChange = now;
+            }
+            limited = radiusCap < requestedRadius;
+        } else if (cacheLimit != SIZE_MAX) {
+            setCacheLimit(SIZE_MAX);
+            lastChange = now;
+        }
+    }
+    return radiusCap;
+}
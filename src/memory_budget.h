@@ -0,0 +1,63 @@
+#pragma once
+#include "world.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Bytes held by each part of the streaming pipeline, measured once per frame from each
+// subsystem's own bookkeeping (vector capacities, cache and arena counters) rather than by
+// hooking the allocator, so the figures are approximate but cost almost nothing to gather.
+enum MemorySubsystem {
+    MEM_BLOCKS = 0,  // block arrays of loaded and pooled chunks
+    MEM_CPU_MESHES,  // vertex and section data kept on the CPU after upload
+    MEM_GPU_MESHES,  // live vertices in the shared GPU vertex buffer
+    MEM_JOB_QUEUES,  // meshes waiting for upload, queued jobs, chunk snapshots waiting to be saved
+    MEM_CACHES,      // chunk cache and spare vertex buffers; can be dropped at any time
+    MEM_SUBSYSTEM_COUNT
+};
+
+const char* memorySubsystemName(MemorySubsystem subsystem);
+
+struct MemoryUsage {
+    size_t bytes[MEM_SUBSYSTEM_COUNT] = {};
+
+    size_t total() const;
+};
+
+// Everything except MEM_GPU_MESHES, which the render layer fills in (chunk_renderer.h).
+MemoryUsage measureWorldMemory(ChunkManager& manager);
+
+struct MemoryBudgetSettings {
+    bool enabled = true;
+    int budgetMB = 1024;
+};
+
+extern MemoryBudgetSettings g_memoryBudget;
+
+// Keeps the streaming pipeline under g_memoryBudget. Over budget it first shrinks the caches,
+// then lowers the load radius a ring at a time, waiting between steps for the unloads to show
+// in the next measurement. Once usage is back under 90% of the budget it raises the radius
+// again, but only as far as the extra chunks are expected to fit, and finally lifts the cache
+// cap. The radius never goes above the one the player asked for.
+class MemoryGovernor {
+public:
+    // Call once per frame before updateChunks; returns the radius to load with.
+    int update(const MemoryUsage& usage, int requestedRadius, size_t loadedChunks);
+
+    const MemoryUsage& usage() const { return measured; }
+    int radius() const { return radiusCap; }
+    bool limitingRadius() const { return limited; }
+    bool limitingCaches() const { return cacheLimit != SIZE_MAX; }
+
+private:
+    static const int MIN_RADIUS = 2;
+    MemoryUsage measured;
+    int radiusCap = -1;
+    bool limited = false;
+    size_t cacheLimit = SIZE_MAX;
+    std::chrono::steady_clock::time_point lastChange;
+
+    void setCacheLimit(size_t limit);
+};
+
+extern MemoryGovernor g_memoryGovernor;
@@ -0,0 +1,155 @@
+#include "perf_overlay.h"
+#include "chunk_cache.h"
+#include "memory_budget.h"
+#include "profiler.h"
+#include "region_storage.h"
+#include "imgui/imgui.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const size_t STAGE_FRAMES = 60;           // frames the stage times are averaged over
+static const uint64_t UTILIZATION_WINDOW = 500000000; // ns between worker utilization samples
+
+static void renderFrameTimes() {
+    static std::vector<float> times;
+    static std::vector<float> sorted;
+    times.clear();
+    for (size_t i = 0; i < g_profiler.frameCount(); i++) times.push_back((float)g_profiler.frame(i).milliseconds());
+    if (times.empty()) return;
+
+    sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    float sum = 0.0f;
+    for (float t : times) sum += t;
+    float p99 = sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), "min %.1f  avg %.1f  p99 %.1f ms", sorted.front(), sum / times.size(), p99);
+    ImGui::PlotLines("##FrameTimes", times.data(), (int)times.size(), 0, overlay, 0.0f,
+                     std::max(33.3f, p99 * 1.25f), ImVec2(-1, 60));
+}
+
+// Outermost main-thread zones, averaged over the last STAGE_FRAMES frames
+static void renderStageTimes() {
+#ifdef VOXEL_PROFILER
+    struct Stage {
+        const char* name;
+        double ms;
+    };
+    static std::vector<Stage> stages;
+    stages.clear();
+
+    std::vector<std::string> names = g_profiler.threadNames();
+    auto mainIt = std::find(names.begin(), names.end(), "Main");
+    if (mainIt == names.end() || !g_profiler.enabled.load()) {
+        ImGui::TextDisabled("Stages: profiler not recording");
+        return;
+    }
+    uint16_t mainThread = (uint16_t)(mainIt - names.begin());
+
+    size_t count = g_profiler.frameCount();
+    size_t frames = std::min(count, STAGE_FRAMES);
+    for (size_t i = count - frames; i < count; i++) {
+        for (const ProfileZoneRecord& z : g_profiler.frame(i).zones) {
+            if (z.thread != mainThread || z.depth != 0) continue;
+            auto it = std::find_if(stages.begin(), stages.end(),
+                                   [&](const Stage& s) { return std::strcmp(s.name, z.name) == 0; });
+            if (it == stages.end()) it = stages.insert(stages.end(), Stage{ z.name, 0.0 });
+            it->ms += (z.end - z.start) * 1e-6;
+        }
+    }
+    for (const Stage& s : stages) ImGui::Text("  %-16s %6.2f ms", s.name, frames ? s.ms / frames : 0.0);
+#else
+    ImGui::TextDisabled("Stages: profiler compiled out");
+#endif
+}
+
+static void renderWorkers(const ChunkStateCounts& chunks) {
+    static uint64_t lastBusy = 0;
+    static uint64_t lastSample = 0;
+    static float utilization = 0.0f;
+
+    WorkerPoolStats pool = getWorkerPoolStats();
+    uint64_t now = g_profiler.now();
+    if (now - lastSample >= UTILIZATION_WINDOW) {
+        if (lastSample != 0 && pool.workers > 0) {
+            utilization = (float)(pool.busyNs - lastBusy) / (float)((now - lastSample) * pool.workers);
+        }
+        lastBusy = pool.busyNs;
+        lastSample = now;
+    }
+
+    char label[32];
+    std::snprintf(label, sizeof(label), "%zu workers %.0f%%", pool.workers, utilization * 100.0f);
+    ImGui::ProgressBar(std::min(utilization, 1.0f), ImVec2(-1, 0), label);
+
+    size_t uploads = g_completedMeshes.size();
+    ImGui::Text("Queues: terrain %d, mesh %d, upload %zu", chunks.inTerrainQueue,
+                std::max(0, chunks.inMeshQueue - (int)uploads), uploads);
+    ImGui::Text("        jobs %zu, saves %zu", pool.queuedJobs, g_regionStorage.pendingWrites());
+}
+
+static void renderDraws(const RenderStats& stats) {
+    ImGui::Text("Drawn: %d chunks (%d culled), %d sections", stats.visibleChunks, stats.culledChunks,
+                stats.visibleSections);
+    ImGui::Text("  sections culled %d, occluded %d", stats.culledSections, stats.occludedSections);
+    ImGui::Text("  %d call(s), %d ranges, leaves %d sections%s", stats.drawCalls, stats.drawRanges,
+                stats.cutoutSections, stats.cutoutSorts ? " (re-sorted)" : "");
+    ImGui::Text("  far terrain %d tiles (%d culled)", stats.visibleFarTiles, stats.culledFarTiles);
+}
+
+static void renderMemory(const RenderStats& stats) {
+    const MemoryUsage& usage = g_memoryGovernor.usage();
+    for (int i = 0; i < MEM_SUBSYSTEM_COUNT; i++) {
+        ImGui::Text("  %-11s %7.1f MB", memorySubsystemName((MemorySubsystem)i), usage.bytes[i] / (1024.0 * 1024.0));
+    }
+    if (g_memoryBudget.enabled) {
+        ImGui::Text("  Total       %7.1f / %d MB%s", usage.total() / (1024.0 * 1024.0), g_memoryBudget.budgetMB,
+                    g_memoryGovernor.limitingRadius() ? " (radius limited)" : "");
+    } else {
+        ImGui::Text("  Total       %7.1f MB", usage.total() / (1024.0 * 1024.0));
+    }
+    if (g_memoryGovernor.limitingCaches()) ImGui::TextDisabled("  caches trimmed to fit the budget");
+
+    const MeshMemoryStats& mesh = stats.meshMemory;
+    ImGui::Text("Meshes: %.1f MB GPU, %.1f MB CPU copies, %.1f MB pooled", mesh.gpuBytes / (1024.0 * 1024.0),
+                mesh.cpuBytes / (1024.0 * 1024.0), mesh.spareBytes / (1024.0 * 1024.0));
+    ChunkCacheStats cache = g_chunkCache.stats();
+    ImGui::Text("Chunk cache: %zu chunks, %.1f MB, %.0f%% hits", cache.entries, cache.bytes / (1024.0 * 1024.0),
+                cache.hitRate() * 100.0f);
+}
+
+void renderPerfOverlay(ChunkManager& manager, const RenderStats& stats) {
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui::SetNextWindowBgAlpha(0.35f);
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - 10, 10), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowSize(ImVec2(340, 0), ImGuiCond_Always);
+    ImGui::Begin("Performance", nullptr,
+        ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings |
+        ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+
+    ImGui::Text("Frame time");
+    renderFrameTimes();
+    renderStageTimes();
+
+    ImGui::Separator();
+    ChunkStateCounts chunks = countChunkStates(manager);
+    renderWorkers(chunks);
+
+    ImGui::Separator();
+    ImGui::Text("Chunks: %d loaded, %d dirty", chunks.loaded, chunks.meshDirty);
+    ImGui::Text("  terrain %d, structures %d, meshed %d", chunks.terrainGenerated, chunks.structuresGenerated,
+                chunks.meshUploaded);
+    ImGui::Text("Vertices: %.2fM loaded, %.2fM drawn", chunks.vertices * 1e-6, stats.drawnVertices * 1e-6);
+    ImGui::Text("Triangles: %.2fM drawn", stats.drawnVertices / 3 * 1e-6);
+    renderDraws(stats);
+
+    ImGui::Separator();
+    ImGui::Text("Memory");
+    renderMemory(stats);
+
+    ImGui::End();
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "chunk_renderer.h"
+#include "world.h"
+
+// Streaming health at a glance: frame-time graph, main-thread stage times (from the profiler
+// zones), worker utilization, queue depths, chunk states, vertex and draw counts, culling, and
+// memory per subsystem with the mesh and chunk cache details.
+void renderPerfOverlay(ChunkManager& manager, const RenderStats& stats);
@@ -1,4 +1,5 @@
 #include "player.h"
+#include "edit_journal.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <cmath>
 #include "imgui/imgui.h"
@@ -122,99 +123,22 @@ void Player::update(float deltaTime, ChunkManager* world) {
 
 // Interaction
 const std::vector<BlockType>& Player::blockList() {
-    static const std::vector<BlockType> list = { AIR, GRASS, DIRT, STONE, ANDESITE, DIORITE, GRANITE, TUFF, WOOD, LEAVES, SNOW};
+    static const std::vector<BlockType> list = [] {
+        std::vector<BlockType> types;
+        for (int t = 0; t < BLOCK_TYPE_COUNT; t++) types.push_back((BlockType)t);
+        return types;
+    }();
     return list;
 }
 
 const char* Player::blockName(BlockType t) {
-    switch (t) {
-        case AIR: return "Air";
-        case GRASS: return "Grass";
-        case DIRT: return "Dirt";
-        case STONE: return "Stone";
-        case ANDESITE: return "Andesite";
-        case DIORITE: return "Diorite";
-        case GRANITE: return "Granite";
-        case TUFF: return "Tuff";
-        case WOOD: return "Wood";
-        case LEAVES: return "Leaves";
-        case SNOW: return "Snow";
-        default: return "Unknown";
-    }
+    if (t >= BLOCK_TYPE_COUNT) return "Unknown";
+    return blockInfo(t).name;
 }
 
 bool Player::raycastBlock(float maxDist, glm::ivec3& outBlock, glm::ivec3& outNormal) const {
     if (!worldRef) return false;
-    glm::vec3 rayOrigin = getCameraPosition() + raycastOriginOffset;
-    glm::vec3 rayDir = glm::normalize(front);
-
-    glm::ivec3 mapPos = glm::ivec3(glm::floor(rayOrigin));
-    glm::vec3 deltaDist = glm::abs(glm::vec3(
-        1.0f / (rayDir.x == 0.0f ? 1e-6f : rayDir.x),
-        1.0f / (rayDir.y == 0.0f ? 1e-6f : rayDir.y),
-        1.0f / (rayDir.z == 0.0f ? 1e-6f : rayDir.z)));
-
-    glm::ivec3 step(
-        rayDir.x < 0 ? -1 : 1,
-        rayDir.y < 0 ? -1 : 1,
-        rayDir.z < 0 ? -1 : 1
-    );
-
-    glm::vec3 sideDist;
-    sideDist.x = ((rayDir.x < 0 ? (rayOrigin.x - (float)mapPos.x) : ((float)mapPos.x + 1.0f - rayOrigin.x))) * deltaDist.x;
-    sideDist.y = ((rayDir.y < 0 ? (rayOrigin.y - (float)mapPos.y) : ((float)mapPos.y + 1.0f - rayOrigin.y))) * deltaDist.y;
-    sideDist.z = ((rayDir.z < 0 ? (rayOrigin.z - (float)mapPos.z) : ((float)mapPos.z + 1.0f - rayOrigin.z))) * deltaDist.z;
-
-    glm::ivec3 hitNormal(0);
-    float dist = 0.0f;
-    const float maxDistEps = maxDist + 1.0f;
-
-    while (dist <= maxDistEps) {
-        int cx = getChunkCoord((float)mapPos.x);
-        int cz = getChunkCoord((float)mapPos.z);
-        ManagedChunk* mc = worldRef->getChunk(cx, cz);
-        if (mc) {
-            int localX = mapPos.x - cx * (int)mc->chunk.width;
-            int localZ = mapPos.z - cz * (int)mc->chunk.depth;
-            if (localX >= 0 && localX < (int)mc->chunk.width &&
-                localZ >= 0 && localZ < (int)mc->chunk.depth &&
-                mapPos.y >= 0 && mapPos.y < (int)mc->chunk.height) {
-                BlockType bt = mc->chunk.getBlock(localX, mapPos.y, localZ).type;
-                if (bt != AIR) {
-                    outBlock = mapPos;
-                    outNormal = hitNormal;
-                    return true;
-                }
-            }
-        }
-
-        if (sideDist.x < sideDist.y) {
-            if (sideDist.x < sideDist.z) {
-                mapPos.x += step.x;
-                dist = sideDist.x;
-                sideDist.x += deltaDist.x;
-                hitNormal = glm::ivec3(-step.x, 0, 0);
-            } else {
-                mapPos.z += step.z;
-                dist = sideDist.z;
-                sideDist.z += deltaDist.z;
-                hitNormal = glm::ivec3(0, 0, -step.z);
-            }
-        } else {
-            if (sideDist.y < sideDist.z) {
-                mapPos.y += step.y;
-                dist = sideDist.y;
-                sideDist.y += deltaDist.y;
-                hitNormal = glm::ivec3(0, -step.y, 0);
-            } else {
-                mapPos.z += step.z;
-                dist = sideDist.z;
-                sideDist.z += deltaDist.z;
-                hitNormal = glm::ivec3(0, 0, -step.z);
-            }
-        }
-    }
-    return false;
+    return raycastWorld(worldRef, getCameraPosition() + raycastOriginOffset, front, maxDist, outBlock, outNormal);
 }
 
 void Player::rebuildChunkMesh(int worldX, int worldZ) {
@@ -244,12 +168,20 @@ void Player::rebuildNeighborsIfEdge(int worldX, int y, int worldZ) {
     if (localZ == (int)mc->chunk.depth - 1) rebuildChunkMesh(worldX, worldZ + 1);
 }
 
+// Edited chunks are written to the region files when they unload.
+void Player::recordEdit(int worldX, int y, int worldZ, BlockType type) {
+    ManagedChunk* mc = worldRef->getChunk(getChunkCoord((float)worldX), getChunkCoord((float)worldZ));
+    if (mc) mc->edited = true;
+    g_editJournal.record(worldX, y, worldZ, type, LogAxis::Y);
+}
+
 void Player::handleMouseButton(int button, int action, int mods) {
     if (action != GLFW_PRESS || !worldRef) return;
     glm::ivec3 hitBlock, hitNormal;
     if (raycastBlock(6.0f, hitBlock, hitNormal)) {
         if (button == GLFW_MOUSE_BUTTON_LEFT) {
             setBlockWorld(worldRef, hitBlock.x, hitBlock.y, hitBlock.z, AIR);
+            recordEdit(hitBlock.x, hitBlock.y, hitBlock.z, AIR);
             rebuildNeighborsIfEdge(hitBlock.x, hitBlock.y, hitBlock.z);
         } else if (button == GLFW_MOUSE_BUTTON_RIGHT) {
             BlockType sel = blockList()[selectedBlock];
@@ -259,6 +191,7 @@ void Player::handleMouseButton(int button, int action, int mods) {
                 AABB blockBox(glm::vec3(placePos.x + 0.5f, placePos.y, placePos.z + 0.5f), 1.0f, 1.0f, 1.0f);
                 if (!playerBox.intersects(blockBox)) {
                     setBlockWorld(worldRef, placePos.x, placePos.y, placePos.z, sel);
+                    recordEdit(placePos.x, placePos.y, placePos.z, sel);
                     rebuildNeighborsIfEdge(placePos.x, placePos.y, placePos.z);
                 }
             }
@@ -348,48 +281,5 @@ glm::vec3 Player::resolveCollision(glm::vec3 desiredPos, ChunkManager* world) {
 }
 
 bool Player::checkCollision(glm::vec3 newPos, ChunkManager* world) {
-    AABB playerBox(newPos, width, height, depth);
-    
-    int minX = (int)floor(playerBox.min.x);
-    int maxX = (int)ceil(playerBox.max.x);
-    int minY = (int)floor(playerBox.min.y);
-    int maxY = (int)ceil(playerBox.max.y);
-    int minZ = (int)floor(playerBox.min.z);
-    int maxZ = (int)ceil(playerBox.max.z);
-    
-    for (int x = minX; x <= maxX; x++) {
-        for (int y = minY; y <= maxY; y++) {
-            for (int z = minZ; z <= maxZ; z++) {
-                int cx = getChunkCoord((float)x);
-                int cz = getChunkCoord((float)z);
-                
-                ManagedChunk* chunk = world->getChunk(cx, cz);
-                if (!chunk) continue;
-                
-                int localX = x - cx * chunk->chunk.width;
-                int localZ = z - cz * chunk->chunk.depth;
-                
-                if (localX < 0 || localX >= (int)chunk->chunk.width ||
-                    localZ < 0 || localZ >= (int)chunk->chunk.depth ||
-                    y < 0 || y >= (int)chunk->chunk.height) {
-                    continue;
-                }
-                
-                BlockType blockType = chunk->chunk.getBlock(localX, y, localZ).type;
-                
-                if (isBlockSolid(blockType)) {
-                    AABB blockBox(glm::vec3(x + 0.5f, y, z + 0.5f), 1.0f, 1.0f, 1.0f);
-                    if (playerBox.intersects(blockBox)) {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-    
-    return false;
+    return collidesWithWorld(world, AABB(newPos, width, height, depth));
 }
-
-bool Player::isBlockSolid(BlockType type) {
-    return type != AIR;
-}
\ No newline at end of file
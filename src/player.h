@@ -4,28 +4,13 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include "world.h"
+#include "collision.h"
 
 enum class MovementMode {
     FLY,
     NORMAL
 };
 
-struct AABB {
-    glm::vec3 min;
-    glm::vec3 max;
-
-    AABB(glm::vec3 center, float width, float height, float depth) {
-        min = center - glm::vec3(width/2.0f, 0.0f, depth/2.0f);
-        max = center + glm::vec3(width/2.0f, height, depth/2.0f);
-    }
-
-    bool intersects(const AABB& other) const {
-        return (min.x <= other.max.x && max.x >= other.min.x) &&
-               (min.y <= other.max.y && max.y >= other.min.y) &&
-               (min.z <= other.max.z && max.z >= other.min.z);
-    }
-};
-
 class Player {
 public:
     glm::vec3 position;
@@ -77,11 +62,12 @@ private:
     void updateVectors();
     bool checkCollision(glm::vec3 newPos, ChunkManager* world);
     glm::vec3 resolveCollision(glm::vec3 desiredPos, ChunkManager* world);
-    bool isBlockSolid(BlockType type);
 
     bool raycastBlock(float maxDist, glm::ivec3& outBlock, glm::ivec3& outNormal) const;
     void rebuildChunkMesh(int worldX, int worldZ);
     void rebuildNeighborsIfEdge(int worldX, int y, int worldZ);
+    // Marks the chunk for saving and appends the change to the edit journal.
+    void recordEdit(int worldX, int y, int worldZ, BlockType type);
 
     int selectedBlock = 1;
     ChunkManager* worldRef = nullptr;
@@ -0,0 +1,154 @@
+#include "profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+Profiler g_profiler;
+
+static thread_local Profiler::ThreadState* t_profileState = nullptr;
+
+Profiler::Profiler() {
+    epoch = 0;
+    epoch = now();
+}
+
+uint64_t Profiler::now() const {
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t).count() - epoch;
+}
+
+Profiler::ThreadState* Profiler::threadState() {
+    if (t_profileState) return t_profileState;
+    auto state = std::make_unique<ThreadState>();
+    state->ring.reset(new ProfileZoneRecord[RING_SIZE]);
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    state->index = (uint16_t)threads.size();
+    state->name = "Thread " + std::to_string(threads.size());
+    t_profileState = state.get();
+    threads.push_back(std::move(state));
+    return t_profileState;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadState* state = threadState();
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    state->name = name;
+}
+
+void Profiler::record(ThreadState* state, const char* name, uint64_t start, uint64_t end, uint16_t depth) {
+    // Single writer per ring; endFrame() only reads up to the published count.
+    uint64_t i = state->written.load(std::memory_order_relaxed);
+    state->ring[i & (RING_SIZE - 1)] = ProfileZoneRecord{ name, start, end, state->index, depth };
+    state->written.store(i + 1, std::memory_order_release);
+}
+
+void Profiler::endFrame() {
+    uint64_t end = now();
+    ProfileFrame& f = frames[frameTotal % FRAME_HISTORY];
+    f.index = frameTotal;
+    f.start = frameStart;
+    f.end = end;
+    f.zones.clear();
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    for (auto& t : threads) {
+        uint64_t written = t->written.load(std::memory_order_acquire);
+        uint64_t from = std::max(t->collected, written > RING_SIZE ? written - RING_SIZE : 0);
+        size_t first = f.zones.size();
+        for (uint64_t i = from; i < written; i++) f.zones.push_back(t->ring[i & (RING_SIZE - 1)]);
+
+        // Anything the thread lapped while it was being copied is unreliable; drop it.
+        uint64_t after = t->written.load(std::memory_order_acquire);
+        if (after > RING_SIZE && after - RING_SIZE > from) {
+            size_t lapped = (size_t)std::min<uint64_t>(after - RING_SIZE - from, written - from);
+            f.zones.erase(f.zones.begin() + first, f.zones.begin() + first + lapped);
+        }
+        t->collected = written;
+
+        // Zones are recorded as they end (children first); start order puts parents first.
+        std::sort(f.zones.begin() + first, f.zones.end(), [](const ProfileZoneRecord& a, const ProfileZoneRecord& b) {
+            return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+        });
+    }
+
+    frameTotal++;
+    frameStart = end;
+
+    if (captureRemaining > 0) {
+        captured.push_back(f);
+        if (--captureRemaining == 0) {
+            if (writeChromeTrace(capturePath, captured, namesLocked())) {
+                std::cout << "Wrote " << captured.size() << " frames to " << capturePath << std::endl;
+            } else {
+                std::cout << "Could not write trace " << capturePath << std::endl;
+            }
+            captured.clear();
+            captured.shrink_to_fit();
+        }
+    }
+}
+
+void Profiler::captureTrace(int frames, const std::string& path) {
+    if (frames <= 0) return;
+    enabled.store(true);
+    captureRemaining = frames;
+    capturePath = path;
+    captured.clear();
+    captured.reserve(frames);
+}
+
+const ProfileFrame& Profiler::frame(size_t i) const {
+    return frames[(frameTotal - frameCount() + i) % FRAME_HISTORY];
+}
+
+std::vector<std::string> Profiler::threadNames() {
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    return namesLocked();
+}
+
+std::vector<std::string> Profiler::namesLocked() {
+    std::vector<std::string> names;
+    for (auto& t : threads) names.push_back(t->name);
+    return names;
+}
+
+static void writeJsonString(std::FILE* f, const char* s) {
+    std::fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) std::fputc(*s, f);
+    }
+    std::fputc('"', f);
+}
+
+bool writeChromeTrace(const std::string& path, const std::vector<ProfileFrame>& frames,
+                      const std::vector<std::string>& threadNames) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+
+    // Timestamps are microseconds; three decimals keep the nanoseconds.
+    const int framesTrack = (int)threadNames.size();
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", f);
+    for (size_t t = 0; t <= threadNames.size(); t++) {
+        std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":", t);
+        writeJsonString(f, t < threadNames.size() ? threadNames[t].c_str() : "Frames");
+        std::fprintf(f, "}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"sort_index\":%zu}},\n",
+                     t, t == threadNames.size() ? 0 : t + 1);
+    }
+    bool first = true;
+    for (const ProfileFrame& frame : frames) {
+        std::fprintf(f, "%s{\"name\":\"Frame %llu\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                     first ? "" : ",\n", (unsigned long long)frame.index, framesTrack, frame.start * 1e-3,
+                     (frame.end - frame.start) * 1e-3);
+        first = false;
+        for (const ProfileZoneRecord& z : frame.zones) {
+            std::fputs(",\n{\"name\":", f);
+            writeJsonString(f, z.name);
+            std::fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         (unsigned)z.thread, z.start * 1e-3, (z.end - z.start) * 1e-3);
+        }
+    }
+    std::fputs("\n]}\n", f);
+    return std::fclose(f) == 0;
+}
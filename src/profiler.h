@@ -0,0 +1,136 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Instrumented-zone frame profiler. PROFILE_SCOPE("name") times the rest of the enclosing block
+// on whatever thread runs it; zones nest, so a frame reads as a tree per thread. Each thread
+// writes its finished zones into its own ring buffer with no locking; the main thread collects
+// all rings once per frame in endFrame() and keeps the last FRAME_HISTORY frames.
+//
+// Zones are only compiled in when VOXEL_PROFILER is defined (the CMake option of the same name);
+// otherwise the macros expand to nothing. Compiled in but switched off at runtime, a zone costs
+// one relaxed load and a branch.
+//
+// Zone names must be string literals (or otherwise outlive the profiler): only the pointer is kept.
+struct ProfileZoneRecord {
+    const char* name;
+    uint64_t start; // ns since the profiler started
+    uint64_t end;
+    uint16_t thread; // index into Profiler::threadNames()
+    uint16_t depth;  // nesting level on its thread, 0 = outermost
+};
+
+struct ProfileFrame {
+    uint64_t index = 0;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    // Zones that finished during the frame, by thread, then in start order (parents before
+    // their children). Worker zones that straddle the boundary land in the frame they end in.
+    std::vector<ProfileZoneRecord> zones;
+
+    double milliseconds() const { return (end - start) * 1e-6; }
+};
+
+class Profiler {
+public:
+    static const size_t RING_SIZE = 1 << 14; // zones per thread between two endFrame() calls
+    static const size_t FRAME_HISTORY = 300;
+
+    Profiler();
+
+    std::atomic<bool> enabled{true};
+
+    uint64_t now() const;
+
+    // Names the calling thread in the views ("Main", "Worker 3", ...).
+    void setThreadName(const std::string& name);
+
+    // Main thread, once per frame: closes the current frame and starts the next.
+    void endFrame();
+
+    // Records the next `frames` frames (switching recording on) and writes them to path as
+    // Chrome trace JSON once the last one ends. Main thread only.
+    void captureTrace(int frames, const std::string& path);
+    bool capturingTrace() const { return captureRemaining > 0; }
+
+    // Recent frames, oldest first. Main thread only (endFrame replaces them).
+    size_t frameCount() const { return frameTotal < FRAME_HISTORY ? (size_t)frameTotal : FRAME_HISTORY; }
+    const ProfileFrame& frame(size_t i) const;
+    const ProfileFrame& latestFrame() const { return frameTotal ? frame(frameCount() - 1) : frames[0]; }
+    std::vector<std::string> threadNames();
+
+    // Used by ProfileZone
+    struct ThreadState;
+    ThreadState* threadState();
+    void record(ThreadState* state, const char* name, uint64_t start, uint64_t end, uint16_t depth);
+
+private:
+    uint64_t epoch;
+    std::mutex threadsMutex;
+    std::vector<std::unique_ptr<ThreadState>> threads;
+
+    std::vector<std::string> namesLocked();
+
+    ProfileFrame frames[FRAME_HISTORY];
+    uint64_t frameTotal = 0;
+    uint64_t frameStart = 0;
+
+    int captureRemaining = 0;
+    std::string capturePath;
+    std::vector<ProfileFrame> captured;
+};
+
+extern Profiler g_profiler;
+
+// Writes frames in the Chrome trace event format (chrome://tracing, ui.perfetto.dev): one track
+// per thread with every zone as a complete event, plus a "Frames" track marking frame bounds.
+bool writeChromeTrace(const std::string& path, const std::vector<ProfileFrame>& frames,
+                      const std::vector<std::string>& threadNames);
+
+struct Profiler::ThreadState {
+    std::string name;
+    uint16_t index = 0;
+    uint16_t depth = 0;
+    std::unique_ptr<ProfileZoneRecord[]> ring;
+    std::atomic<uint64_t> written{0};
+    uint64_t collected = 0; // main thread only
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) {
+        if (!g_profiler.enabled.load(std::memory_order_relaxed)) return;
+        state = g_profiler.threadState();
+        zoneName = name;
+        depth = state->depth++;
+        start = g_profiler.now();
+    }
+    ~ProfileZone() {
+        if (!state) return;
+        state->depth--;
+        g_profiler.record(state, zoneName, start, g_profiler.now(), depth);
+    }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    Profiler::ThreadState* state = nullptr;
+    const char* zoneName = nullptr;
+    uint64_t start = 0;
+    uint16_t depth = 0;
+};
+
+#ifdef VOXEL_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_THREAD(name) g_profiler.setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
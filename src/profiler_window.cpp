@@ -0,0 +1,85 @@
+#include "profiler_window.h"
+#include "profiler.h"
+#include "imgui/imgui.h"
+#include <string>
+#include <vector>
+
+// Zone tree of one thread: zones[begin, end) are in start order with their nesting depth.
+static void renderZoneTree(const std::vector<ProfileZoneRecord>& zones, size_t begin, size_t end) {
+    int openDepth = 0; // tree nodes currently pushed
+    for (size_t i = begin; i < end; i++) {
+        const ProfileZoneRecord& z = zones[i];
+        while (openDepth > z.depth) {
+            ImGui::TreePop();
+            openDepth--;
+        }
+        if (z.depth > openDepth) continue; // inside a collapsed parent
+
+        bool hasChildren = i + 1 < end && zones[i + 1].depth > z.depth;
+        ImGuiTreeNodeFlags flags = hasChildren ? 0 : ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        if (z.depth == 0) flags |= ImGuiTreeNodeFlags_DefaultOpen;
+        bool open = ImGui::TreeNodeEx((const void*)(uintptr_t)i, flags, "%s  %.3f ms", z.name, (z.end - z.start) * 1e-6);
+        if (hasChildren && open) openDepth++;
+    }
+    while (openDepth > 0) {
+        ImGui::TreePop();
+        openDepth--;
+    }
+}
+
+void renderProfilerWindow(bool* open) {
+    static bool paused = false;
+    static ProfileFrame held;
+
+    ImGui::SetNextWindowPos(ImVec2(10, 260), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(420, 480), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+
+#ifndef VOXEL_PROFILER
+    ImGui::TextDisabled("Zones are compiled out (build with VOXEL_PROFILER=ON)");
+#endif
+    bool recording = g_profiler.enabled.load();
+    if (ImGui::Checkbox("Record", &recording)) g_profiler.enabled.store(recording);
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &paused);
+    ImGui::SameLine();
+    if (ImGui::Button("Slowest frame") && g_profiler.frameCount() > 0) {
+        size_t worst = 0;
+        for (size_t i = 1; i < g_profiler.frameCount(); i++) {
+            if (g_profiler.frame(i).milliseconds() > g_profiler.frame(worst).milliseconds()) worst = i;
+        }
+        held = g_profiler.frame(worst);
+        paused = true;
+    }
+    if (!paused) held = g_profiler.latestFrame();
+
+    ImGui::Text("Frame %llu: %.2f ms", (unsigned long long)held.index, held.milliseconds());
+    ImGui::Separator();
+
+    std::vector<std::string> names = g_profiler.threadNames();
+    size_t begin = 0;
+    while (begin < held.zones.size()) {
+        uint16_t thread = held.zones[begin].thread;
+        size_t end = begin;
+        uint64_t busy = 0;
+        for (; end < held.zones.size() && held.zones[end].thread == thread; end++) {
+            if (held.zones[end].depth == 0) busy += held.zones[end].end - held.zones[end].start;
+        }
+
+        std::string name = thread < names.size() ? names[thread] : "Thread " + std::to_string(thread);
+        ImGui::PushID(thread);
+        // The busy time changes every frame; only the part after ### feeds the ID, so the header
+        // keeps its open state.
+        std::string header = name + "  (" + std::to_string(busy / 1000) + " us busy)###" + name;
+        if (ImGui::CollapsingHeader(header.c_str(), name == "Main" ? ImGuiTreeNodeFlags_DefaultOpen : 0)) {
+            renderZoneTree(held.zones, begin, end);
+        }
+        ImGui::PopID();
+        begin = end;
+    }
+
+    ImGui::End();
+}
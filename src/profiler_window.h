@@ -0,0 +1,5 @@
+#pragma once
+
+// ImGui view of the frame profiler (profiler.h): the zone tree of one frame per thread, either
+// live or frozen, e.g. on the slowest recent frame to see where a spike came from.
+void renderProfilerWindow(bool* open);
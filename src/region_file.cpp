@@ -0,0 +1,298 @@
+#include "region_file.h"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const char REGION_MAGIC[4] = { 'V', 'X', 'R', 'G' };
+static const uint32_t REGION_VERSION = 1;
+static const long HEADER_PREFIX = 8;
+
+struct Crc32Table {
+    uint32_t entries[256];
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+    }
+};
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    // Function-local static: built once, safely, by whichever reader thread gets here first.
+    static const Crc32Table table;
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) c = table.entries[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+// Flushes stdio buffers and asks the OS to put the bytes on disk.
+static bool syncFile(std::FILE* f) {
+    if (std::fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+RegionFile::RegionFile(const std::string& path) : path(path) {
+    openFile();
+}
+
+RegionFile::~RegionFile() {
+    closeFile();
+}
+
+void RegionFile::closeFile() {
+    unmapFile();
+    if (file) std::fclose(file);
+    file = nullptr;
+}
+
+bool RegionFile::mapFile() {
+    unmapFile();
+    if (!file || endOffset == 0) return false;
+#ifdef _WIN32
+    HANDLE fileHandle = (HANDLE)_get_osfhandle(_fileno(file));
+    HANDLE mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    mappingHandle = mapping;
+#else
+    void* view = mmap(nullptr, (size_t)endOffset, PROT_READ, MAP_SHARED, fileno(file), 0);
+    if (view == MAP_FAILED) return false;
+#endif
+    mapped = (const uint8_t*)view;
+    mappedBytes = endOffset;
+    return true;
+}
+
+void RegionFile::unmapFile() {
+    if (!mapped) return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapped);
+    CloseHandle((HANDLE)mappingHandle);
+    mappingHandle = nullptr;
+#else
+    munmap((void*)mapped, (size_t)mappedBytes);
+#endif
+    mapped = nullptr;
+    mappedBytes = 0;
+}
+
+bool RegionFile::openFile() {
+    std::memset(slots, 0, sizeof(slots));
+    file = std::fopen(path.c_str(), "r+b");
+    if (!file) {
+        // New region: write an empty header first.
+        file = std::fopen(path.c_str(), "w+b");
+        if (!file) return false;
+        std::fwrite(REGION_MAGIC, 1, 4, file);
+        std::fwrite(&REGION_VERSION, sizeof(REGION_VERSION), 1, file);
+        std::fwrite(slots, sizeof(Slot), SLOTS, file);
+        if (!syncFile(file)) {
+            std::fclose(file);
+            file = nullptr;
+            return false;
+        }
+        std::rewind(file);
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    if (std::fread(magic, 1, 4, file) != 4 || std::memcmp(magic, REGION_MAGIC, 4) != 0 ||
+        std::fread(&version, sizeof(version), 1, file) != 1 || version != REGION_VERSION ||
+        std::fread(slots, sizeof(Slot), SLOTS, file) != (size_t)SLOTS) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    std::fseek(file, 0, SEEK_END);
+    endOffset = (uint64_t)std::ftell(file);
+    mapFile();
+    return true;
+}
+
+bool RegionFile::slotValid(const Slot& s) const {
+    if (s.sequence == 0) return false;
+    if (crc32((const uint8_t*)&s, offsetof(Slot, slotCrc)) != s.slotCrc) return false;
+    return s.offset + s.length <= endOffset;
+}
+
+int RegionFile::newestSlot(int chunkIndex) const {
+    int best = -1;
+    for (int i = chunkIndex * 2; i < chunkIndex * 2 + 2; i++) {
+        if (slotValid(slots[i]) && (best < 0 || slots[i].sequence > slots[best].sequence)) best = i;
+    }
+    return best;
+}
+
+const uint8_t* RegionFile::mappedPayload(const Slot& s) const {
+    if (!mapped || s.offset + s.length > mappedBytes) return nullptr;
+    const uint8_t* data = mapped + s.offset;
+    return crc32(data, s.length) == s.payloadCrc ? data : nullptr;
+}
+
+const RegionFile::Slot* RegionFile::readableSlot(int chunkIndex, const uint8_t*& payload) const {
+    payload = nullptr;
+    int newest = newestSlot(chunkIndex);
+    if (newest < 0) return nullptr;
+    payload = mappedPayload(slots[newest]);
+    if (payload) return &slots[newest];
+
+    // Newest payload is damaged: fall back to the previous version if it is intact.
+    const Slot& other = slots[newest ^ 1];
+    payload = slotValid(other) ? mappedPayload(other) : nullptr;
+    return payload ? &other : nullptr;
+}
+
+bool RegionFile::visit(int localX, int localZ, const std::function<bool(const uint8_t*, size_t)>& consume) {
+    int chunkIndex = localX + localZ * REGION_SIZE;
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    if (!file) return false;
+
+    int newest = newestSlot(chunkIndex);
+    if (newest < 0) return false;
+    if (slots[newest].offset + slots[newest].length > mappedBytes) {
+        // Written after the map was made: grow the map, then look the chunk up again.
+        lock.unlock();
+        {
+            std::unique_lock<std::shared_mutex> grow(mtx);
+            if (file && endOffset > mappedBytes) mapFile();
+        }
+        lock.lock();
+    }
+
+    const uint8_t* data;
+    const Slot* s = readableSlot(chunkIndex, data);
+    return s && consume(data, s->length);
+}
+
+bool RegionFile::read(int localX, int localZ, std::vector<uint8_t>& out) {
+    return visit(localX, localZ, [&out](const uint8_t* data, size_t size) {
+        out.assign(data, data + size);
+        return true;
+    });
+}
+
+void RegionFile::prefetch(int localX, int localZ) {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    int newest = newestSlot(localX + localZ * REGION_SIZE);
+    if (newest < 0 || !mapped) return;
+    const Slot& s = slots[newest];
+    if (s.offset + s.length > mappedBytes) return; // just written, still in the page cache
+#ifndef _WIN32
+    static const uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t begin = s.offset / pageSize * pageSize;
+    madvise((void*)(mapped + begin), (size_t)(s.offset + s.length - begin), MADV_WILLNEED);
+#endif
+}
+
+bool RegionFile::write(int localX, int localZ, const uint8_t* data, size_t size) {
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    if (!file) return false;
+
+    // 1. Append the payload and make it durable before anything points at it.
+    if (std::fseek(file, (long)endOffset, SEEK_SET) != 0) return false;
+    if (std::fwrite(data, 1, size, file) != size || !syncFile(file)) return false;
+
+    // 2. Replace the older slot, leaving the current one intact until this one is on disk.
+    int chunkIndex = localX + localZ * REGION_SIZE;
+    int newest = newestSlot(chunkIndex);
+    int target = (newest < 0) ? chunkIndex * 2 : (newest ^ 1);
+
+    Slot s;
+    std::memset(&s, 0, sizeof(s));
+    s.offset = endOffset;
+    s.length = (uint32_t)size;
+    s.payloadCrc = crc32(data, size);
+    s.sequence = (newest < 0) ? 1 : slots[newest].sequence + 1;
+    s.slotCrc = crc32((const uint8_t*)&s, offsetof(Slot, slotCrc));
+
+    long slotPos = HEADER_PREFIX + (long)(target * sizeof(Slot));
+    if (std::fseek(file, slotPos, SEEK_SET) != 0) return false;
+    if (std::fwrite(&s, sizeof(Slot), 1, file) != 1 || !syncFile(file)) return false;
+
+    slots[target] = s;
+    endOffset += size;
+    return true;
+}
+
+uint64_t RegionFile::fileBytes() {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return endOffset;
+}
+
+uint64_t RegionFile::garbageBytes() {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    uint64_t live = HEADER_PREFIX + sizeof(slots);
+    for (int c = 0; c < REGION_SIZE * REGION_SIZE; c++) {
+        int newest = newestSlot(c);
+        if (newest >= 0) live += slots[newest].length;
+    }
+    return endOffset > live ? endOffset - live : 0;
+}
+
+bool RegionFile::compact() {
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    if (!file) return false;
+    if (endOffset > mappedBytes && !mapFile()) return false;
+
+    std::string tmpPath = path + ".tmp";
+    std::FILE* out = std::fopen(tmpPath.c_str(), "wb");
+    if (!out) return false;
+
+    Slot fresh[SLOTS];
+    std::memset(fresh, 0, sizeof(fresh));
+    std::fwrite(REGION_MAGIC, 1, 4, out);
+    std::fwrite(&REGION_VERSION, sizeof(REGION_VERSION), 1, out);
+    std::fwrite(fresh, sizeof(Slot), SLOTS, out);
+
+    uint64_t offset = HEADER_PREFIX + sizeof(fresh);
+    bool ok = true;
+    for (int c = 0; c < REGION_SIZE * REGION_SIZE && ok; c++) {
+        // Same choice as visit(), so a chunk that still loads is never dropped.
+        const uint8_t* payload;
+        const Slot* live = readableSlot(c, payload);
+        if (!live) continue;
+        ok = std::fwrite(payload, 1, live->length, out) == live->length;
+
+        Slot& s = fresh[c * 2];
+        s.offset = offset;
+        s.length = live->length;
+        s.payloadCrc = live->payloadCrc;
+        s.sequence = 1;
+        s.slotCrc = crc32((const uint8_t*)&s, offsetof(Slot, slotCrc));
+        offset += live->length;
+    }
+    ok = ok && std::fseek(out, HEADER_PREFIX, SEEK_SET) == 0 &&
+         std::fwrite(fresh, sizeof(Slot), SLOTS, out) == (size_t)SLOTS && syncFile(out);
+    std::fclose(out);
+
+    if (!ok) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    // The rename is the commit point: before it the old file is untouched, after it the new one is complete.
+    closeFile();
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) std::remove(tmpPath.c_str());
+    return openFile();
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// One file per REGION_SIZE x REGION_SIZE chunks. Layout:
+//
+//   header  magic "VXRG", version, then two slots per chunk {offset, length, payload crc,
+//           sequence, slot crc}
+//   data    chunk payloads, append-only
+//
+// A write appends the new payload and syncs it, then overwrites the older of the chunk's two
+// slots with a higher sequence number and syncs again. A crash at any point leaves either the
+// old or the new slot valid (each slot and payload carries a CRC32), so a region is never left
+// pointing at half-written data. Space taken by superseded payloads is reclaimed by compact().
+// Integers are stored in host byte order (little-endian on every platform we ship).
+//
+// Reads go through a read-only memory map of the file: payloads are CRC-checked and handed to
+// the caller straight from the mapped pages, with no intermediate buffer. The map is grown
+// lazily when a read reaches past it after appends.
+const int REGION_SIZE = 32;
+
+uint32_t crc32(const uint8_t* data, size_t size);
+
+class RegionFile {
+public:
+    explicit RegionFile(const std::string& path);
+    ~RegionFile();
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Calls consume with the chunk's payload in the mapped file (valid only during the call) and
+    // returns its result. False when the chunk was never stored or no slot has intact data.
+    // Concurrent reads of one region run in parallel.
+    bool visit(int localX, int localZ, const std::function<bool(const uint8_t*, size_t)>& consume);
+    // Copying read, for callers that need the payload after the region may change.
+    bool read(int localX, int localZ, std::vector<uint8_t>& out);
+    // Hints the OS to start reading the chunk's payload pages in the background.
+    void prefetch(int localX, int localZ);
+    bool write(int localX, int localZ, const uint8_t* data, size_t size);
+
+    // Bytes of payloads that no slot points at any more.
+    uint64_t garbageBytes();
+    uint64_t fileBytes();
+
+    // Rewrites the live payloads into a fresh file next to this one and atomically renames it
+    // over the original.
+    bool compact();
+
+private:
+    struct Slot {
+        uint64_t offset;
+        uint32_t length;
+        uint32_t payloadCrc;
+        uint32_t sequence;
+        uint32_t slotCrc;
+    };
+    static const int SLOTS = REGION_SIZE * REGION_SIZE * 2;
+
+    std::string path;
+    std::FILE* file = nullptr;
+    Slot slots[SLOTS];
+    uint64_t endOffset = 0;
+    std::shared_mutex mtx; // shared for reads of the map, exclusive for writes and remapping
+
+    const uint8_t* mapped = nullptr;
+    uint64_t mappedBytes = 0;
+#ifdef _WIN32
+    void* mappingHandle = nullptr;
+#endif
+
+    bool openFile();
+    void closeFile();
+    bool mapFile();
+    void unmapFile();
+    bool slotValid(const Slot& s) const;
+    // Mapped, CRC-checked payload of a slot, or nullptr. Needs mtx held and the map covering it.
+    const uint8_t* mappedPayload(const Slot& s) const;
+    // Index of the valid slot with the highest sequence for a chunk, or -1.
+    int newestSlot(int chunkIndex) const;
+    // Slot to read a chunk from: the newest one, or the previous version if the newest payload
+    // is damaged. Sets payload; nullptr if neither is intact. Needs mtx held and the map current.
+    const Slot* readableSlot(int chunkIndex, const uint8_t*& payload) const;
+};
@@ -0,0 +1,260 @@
+#include "region_storage.h"
+#include "chunk_codec.h"
+#include "profiler.h"
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <unordered_set>
+
+RegionStorage g_regionStorage;
+SaveSettings g_saveSettings;
+
+static int floorDiv(int a, int b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+RegionStorage::~RegionStorage() {
+    close();
+}
+
+bool RegionStorage::open(const std::string& dir) {
+    close();
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        std::cout << "Could not create save directory " << dir << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    directory = dir;
+    stopping = false;
+    running = true;
+    writer = std::thread(&RegionStorage::writerLoop, this);
+    return true;
+}
+
+void RegionStorage::close() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCv.notify_all();
+    writer.join();
+
+    // Stop taking loads, then wait for the ones already reading before closing the files.
+    running = false;
+    while (activeLoads.load() > 0) std::this_thread::yield();
+
+    std::lock_guard<std::mutex> lock(filesMutex);
+    for (auto& pair : files) {
+        RegionFile& region = *pair.second;
+        // Reclaim superseded payloads once they make up most of the file.
+        if (region.garbageBytes() * 2 > region.fileBytes()) region.compact();
+    }
+    files.clear();
+    missingRegions.clear();
+}
+
+RegionFile* RegionStorage::regionFor(int cx, int cz, int& localX, int& localZ, bool create) {
+    int rx = floorDiv(cx, REGION_SIZE);
+    int rz = floorDiv(cz, REGION_SIZE);
+    localX = cx - rx * REGION_SIZE;
+    localZ = cz - rz * REGION_SIZE;
+
+    Key key(rx, rz);
+    std::lock_guard<std::mutex> lock(filesMutex);
+    auto it = files.find(key);
+    if (it == files.end()) {
+        // Loads of never-saved areas must not leave empty region files behind. Remember misses so
+        // loads and prefetches don't hit the filesystem for them again.
+        if (!create && missingRegions.count(key)) return nullptr;
+        std::string path = directory + "/r." + std::to_string(rx) + "." + std::to_string(rz) + ".vxr";
+        if (!create && !std::filesystem::exists(path)) {
+            missingRegions.insert(key);
+            return nullptr;
+        }
+        missingRegions.erase(key);
+        std::unique_ptr<RegionFile> region(new RegionFile(path));
+        if (!region->isOpen()) std::cout << "Could not open region file " << path << std::endl;
+        it = files.emplace(key, std::move(region)).first;
+    }
+    return it->second->isOpen() ? it->second.get() : nullptr;
+}
+
+bool RegionStorage::loadChunk(Chunk& chunk) {
+    PROFILE_SCOPE("Load chunk");
+    activeLoads++;
+    bool ok = running && loadChunkLocked(chunk);
+    activeLoads--;
+    return ok;
+}
+
+bool RegionStorage::loadChunkLocked(Chunk& chunk) {
+
+    Snapshot snapshot;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        auto it = pending.find({chunk.chunkX, chunk.chunkZ});
+        if (it != pending.end()) snapshot = it->second;
+    }
+    if (snapshot) {
+        chunk.blocks = snapshot->blocks;
+        return true;
+    }
+
+    int localX, localZ;
+    RegionFile* region = regionFor(chunk.chunkX, chunk.chunkZ, localX, localZ, false);
+    if (!region) return false;
+
+    // Full payloads are decoded straight out of the mapped file into the chunk's block storage.
+    // Deltas are small: copy them out so terrain generation doesn't run under the region's lock.
+    std::vector<uint8_t> delta;
+    bool ok = region->visit(localX, localZ, [&](const uint8_t* data, size_t size) {
+        if (isChunkDelta(data, size)) {
+            delta.assign(data, data + size);
+            return true;
+        }
+        return decodeChunkBlocks(data, size, chunk);
+    });
+    if (!ok) return false;
+    if (delta.empty()) return true;
+
+    // Edits diffed against another generator's terrain would land on the wrong blocks.
+    uint32_t generator = chunkDeltaGeneratorVersion(delta.data(), delta.size());
+    if (generator != TERRAIN_GENERATOR_VERSION) {
+        std::cout << "Cannot restore edits in chunk " << chunk.chunkX << ", " << chunk.chunkZ
+                  << ": saved against terrain generator version " << generator << ", this build has version "
+                  << TERRAIN_GENERATOR_VERSION << std::endl;
+        return false;
+    }
+    generateTerrainForChunk(chunk);
+    return applyChunkDelta(delta.data(), delta.size(), chunk);
+}
+
+void RegionStorage::prefetchAhead(glm::vec3 pos, glm::vec3 velocity, int radius) {
+    if (!running) return;
+    float speed = std::sqrt(velocity.x * velocity.x + velocity.z * velocity.z);
+    if (speed < 0.5f) return; // standing still: the load ring is already on disk or in memory
+
+    int cx = getChunkCoord(pos.x);
+    int cz = getChunkCoord(pos.z);
+    float dirX = velocity.x / speed;
+    float dirZ = velocity.z / speed;
+    // Re-issue only when the player enters a new chunk or turns noticeably.
+    if (cx == lastPrefetchX && cz == lastPrefetchZ &&
+        dirX * lastPrefetchDirX + dirZ * lastPrefetchDirZ > 0.9f) return;
+    lastPrefetchX = cx;
+    lastPrefetchZ = cz;
+    lastPrefetchDirX = dirX;
+    lastPrefetchDirZ = dirZ;
+
+    // Band across the direction of travel, from just inside the load radius to a few chunks past
+    // it: the chunks the next updates will ask for.
+    std::unordered_set<Key, pair_hash> seen;
+    for (int ahead = radius - 2; ahead <= radius + PREFETCH_DEPTH; ahead++) {
+        for (int side = -radius; side <= radius; side++) {
+            int tx = cx + (int)std::lround(dirX * ahead - dirZ * side);
+            int tz = cz + (int)std::lround(dirZ * ahead + dirX * side);
+            if (!seen.insert({tx, tz}).second) continue;
+
+            int localX, localZ;
+            RegionFile* region = regionFor(tx, tz, localX, localZ, false);
+            if (region) region->prefetch(localX, localZ);
+        }
+    }
+}
+
+void RegionStorage::saveChunkAsync(const Chunk& chunk) {
+    if (!running) return;
+
+    Snapshot copy = std::make_shared<const Chunk>(chunk);
+    Key key(chunk.chunkX, chunk.chunkZ);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending[key] = copy;
+        queue.push_back({key, copy, g_saveSettings.editDeltas, nullptr});
+    }
+    queueCv.notify_one();
+}
+
+static void encodeForSave(const Chunk& chunk, bool delta, std::vector<uint8_t>& out) {
+    if (!delta) {
+        encodeChunkBlocks(chunk, out);
+        return;
+    }
+    Chunk base(chunk.chunkX, chunk.chunkZ, chunk.width, chunk.depth, chunk.height);
+    generateTerrainForChunk(base);
+    encodeChunkDelta(chunk, base, TERRAIN_GENERATOR_VERSION, out);
+
+    // A heavily rebuilt chunk can be smaller as plain runs.
+    if (out.size() > 1024) {
+        std::vector<uint8_t> full;
+        encodeChunkBlocks(chunk, full);
+        if (full.size() < out.size()) out.swap(full);
+    }
+}
+
+void RegionStorage::whenWritten(std::function<void(bool ok)> callback) {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back({Key(), nullptr, false, std::move(callback)});
+    }
+    queueCv.notify_one();
+}
+
+size_t RegionStorage::pendingWrites() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return queue.size();
+}
+
+void RegionStorage::writerLoop() {
+    PROFILE_THREAD("Region IO");
+    std::vector<uint8_t> data;
+    bool failedSinceBarrier = false;
+    while (true) {
+        SaveJob job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // stopping and drained
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        if (!job.chunk) {
+            job.onWritten(!failedSinceBarrier);
+            failedSinceBarrier = false;
+            continue;
+        }
+
+        PROFILE_SCOPE("Save chunk");
+        encodeForSave(*job.chunk, job.delta, data);
+
+        int localX, localZ;
+        RegionFile* region = regionFor(job.key.first, job.key.second, localX, localZ, true);
+        bool ok = region && region->write(localX, localZ, data.data(), data.size());
+        if (!ok) {
+            // Keep serving it from memory for the rest of the session.
+            std::cout << "Failed to save chunk " << job.key.first << ", " << job.key.second << std::endl;
+            failedSinceBarrier = true;
+            continue;
+        }
+
+        // Only forget the in-memory copy if no newer save of this chunk was queued meanwhile.
+        std::lock_guard<std::mutex> lock(queueMutex);
+        auto it = pending.find(job.key);
+        if (it != pending.end() && it->second == job.chunk) pending.erase(it);
+    }
+}
+
+void saveEditedChunks(ChunkManager& manager) {
+    for (auto& pair : manager.chunks) {
+        ManagedChunk* mc = pair.second;
+        if (mc->edited && mc->terrainGenerated) {
+            g_regionStorage.saveChunkAsync(mc->chunk);
+            mc->edited = false;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "chunk.h"
+#include "region_file.h"
+#include "world.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <glm/glm.hpp>
+
+struct SaveSettings {
+    // Store only the blocks that differ from freshly generated terrain; loads regenerate the
+    // terrain and apply the edits on top. Off stores every block of the chunk.
+    bool editDeltas = true;
+};
+
+extern SaveSettings g_saveSettings;
+
+// Chunk persistence on top of region files. Saves snapshot the chunk on the caller's thread;
+// encoding and writing happen on a dedicated IO thread, so unloading never waits on the disk.
+// Loads run on the world-generation workers. A save that has not reached the disk yet is served
+// from memory, so a chunk that is unloaded and quickly reloaded never reads stale data.
+// Either payload kind (full or edit delta) can be read back, whatever the current setting.
+class RegionStorage {
+public:
+    ~RegionStorage();
+
+    // Creates the directory if needed and starts the IO thread.
+    bool open(const std::string& directory);
+    // Writes every queued save, then stops the IO thread and closes the region files.
+    void close();
+    bool isOpen() const { return running; }
+
+    // Fills chunk from disk; false when storage is closed or the chunk was never saved.
+    bool loadChunk(Chunk& chunk);
+    void saveChunkAsync(const Chunk& chunk);
+
+    // Asks the OS to page in saved chunks in the player's direction of travel, so they are in
+    // memory by the time the generation workers load them. Cheap to call every frame.
+    void prefetchAhead(glm::vec3 pos, glm::vec3 velocity, int radius);
+
+    size_t pendingWrites();
+
+    // Runs callback on the IO thread once every save queued before it has been written; ok is
+    // false if any of them failed since the previous barrier. Never runs if storage is closed.
+    void whenWritten(std::function<void(bool ok)> callback);
+
+private:
+    typedef std::pair<int,int> Key;
+    typedef std::shared_ptr<const Chunk> Snapshot;
+    struct SaveJob {
+        Key key;
+        Snapshot chunk; // nullptr for a barrier
+        bool delta;
+        std::function<void(bool)> onWritten;
+    };
+
+    std::string directory;
+    std::atomic<bool> running{false};
+    std::atomic<int> activeLoads{0};
+
+    std::mutex filesMutex;
+    std::unordered_map<Key, std::unique_ptr<RegionFile>, pair_hash> files;
+    std::unordered_set<Key, pair_hash> missingRegions; // regions with no file on disk (yet)
+
+    std::mutex queueMutex;
+    std::condition_variable queueCv;
+    std::deque<SaveJob> queue;
+    std::unordered_map<Key, Snapshot, pair_hash> pending; // latest unsaved copy per chunk
+    bool stopping = false;
+    std::thread writer;
+
+    static const int PREFETCH_DEPTH = 4; // chunks past the load radius
+    int lastPrefetchX = 0, lastPrefetchZ = 0;
+    float lastPrefetchDirX = 0.0f, lastPrefetchDirZ = 0.0f;
+
+    RegionFile* regionFor(int cx, int cz, int& localX, int& localZ, bool create);
+    bool loadChunkLocked(Chunk& chunk);
+    void writerLoop();
+};
+
+extern RegionStorage g_regionStorage;
+
+// Queues a save of every chunk the player has edited (used on shutdown).
+void saveEditedChunks(ChunkManager& manager);
@@ -1,22 +1,29 @@
 #include "renderer.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stbimage/stb_image.h"
+#include "texture_atlas.h"
 #include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
 
 const char* vertexShaderSrc = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aUV;
+layout (location = 1) in uint aTex; // u | v << 8 | layer << 16
 
-out vec2 TexCoord;
+out vec3 TexCoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+};
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    TexCoord = aUV;
+    // Chunk vertices are already in world space.
+    gl_Position = viewProj * vec4(aPos, 1.0);
+    TexCoord = vec3(float(aTex & 0xFFu), float((aTex >> 8) & 0xFFu), float(aTex >> 16));
 }
 )";
 
@@ -24,28 +31,54 @@ const char* fragmentShaderSrc = R"(
 #version 330 core
 out vec4 FragColor;
 
-in vec2 TexCoord;
-uniform sampler2D tex0;
+in vec3 TexCoord;
+uniform sampler2DArray tex0;
 
 void main() {
     FragColor = texture(tex0, TexCoord);
 }
 )";
 
-Renderer::Renderer() : shaderProgram(0), atlasTexture(0) {
+// Leaves pass: drops empty texels and blends the soft edges mip-mapping leaves behind. Kept a
+// separate program so the opaque shader has no discard and keeps early depth testing.
+const char* cutoutFragmentShaderSrc = R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec3 TexCoord;
+uniform sampler2DArray tex0;
+
+void main() {
+    vec4 color = texture(tex0, TexCoord);
+    if (color.a < 0.1) discard;
+    FragColor = color;
+}
+)";
+
+Renderer::Renderer() : shaderProgram(0), cutoutProgram(0), blockTextures(0), cameraUBO(0) {
 }
 
 Renderer::~Renderer() {
     if (shaderProgram) glDeleteProgram(shaderProgram);
-    if (atlasTexture) glDeleteTextures(1, &atlasTexture);
+    if (cutoutProgram) glDeleteProgram(cutoutProgram);
+    if (blockTextures) glDeleteTextures(1, &blockTextures);
+    if (cameraUBO) glDeleteBuffers(1, &cameraUBO);
 }
 
 bool Renderer::initialize() {
-    shaderProgram = createShaderProgram();
-    if (!shaderProgram) return false;
+    shaderProgram = createShaderProgram(fragmentShaderSrc);
+    cutoutProgram = createShaderProgram(cutoutFragmentShaderSrc);
+    if (!shaderProgram || !cutoutProgram) return false;
+    uniforms = cacheUniforms(shaderProgram);
+    cutoutUniforms = cacheUniforms(cutoutProgram);
+
+    glGenBuffers(1, &cameraUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BINDING, cameraUBO);
 
-    atlasTexture = loadTexture("../src/textures/atlas.png");
-    if (!atlasTexture) return false;
+    blockTextures = loadTextureArray("../src/textures/");
+    if (!blockTextures) return false;
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
@@ -55,6 +88,44 @@ bool Renderer::initialize() {
     return true;
 }
 
+ChunkShaderUniforms Renderer::cacheUniforms(unsigned int program) {
+    ChunkShaderUniforms u;
+    u.tex0 = glGetUniformLocation(program, "tex0");
+    u.cameraBlock = glGetUniformBlockIndex(program, "Camera");
+    if (u.cameraBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, u.cameraBlock, CAMERA_BINDING);
+    }
+
+    // Samplers never change, so set them once here instead of every frame.
+    glUseProgram(program);
+    glUniform1i(u.tex0, 0);
+    return u;
+}
+
+void Renderer::beginChunkPass(const glm::mat4& view, const glm::mat4& projection) {
+    CameraUniforms camera;
+    camera.view = view;
+    camera.projection = projection;
+    camera.viewProj = projection * view;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraUniforms), &camera);
+
+    glUseProgram(shaderProgram);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, blockTextures);
+}
+
+void Renderer::beginCutoutPass() {
+    glUseProgram(cutoutProgram);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void Renderer::endCutoutPass() {
+    glDisable(GL_BLEND);
+}
+
 unsigned int Renderer::compileShader(unsigned int type, const char* src) {
     unsigned int shader = glCreateShader(type);
     glShaderSource(shader, 1, &src, nullptr);
@@ -71,9 +142,9 @@ unsigned int Renderer::compileShader(unsigned int type, const char* src) {
     return shader;
 }
 
-unsigned int Renderer::createShaderProgram() {
+unsigned int Renderer::createShaderProgram(const char* fragmentSrc) {
     unsigned int vs = compileShader(GL_VERTEX_SHADER, vertexShaderSrc);
-    unsigned int fs = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSrc);
+    unsigned int fs = compileShader(GL_FRAGMENT_SHADER, fragmentSrc);
 
     unsigned int program = glCreateProgram();
     glAttachShader(program, vs);
@@ -93,33 +164,48 @@ unsigned int Renderer::createShaderProgram() {
     return program;
 }
 
-GLuint Renderer::loadTexture(const char* path) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, channels;
+GLuint Renderer::loadTextureArray(const std::string& directory) {
     stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path, &width, &height, &channels, 0);
 
-    if (!data) {
-        std::cout << "Failed to load texture: " << path << std::endl;
-        return 0;
+    int layerWidth = 0, layerHeight = 0;
+    std::vector<unsigned char> pixels;
+    for (int layer = 0; layer < LAYER_COUNT; layer++) {
+        std::string path = directory + textureLayerFiles[layer];
+        int width, height, channels;
+        unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+
+        if (!data) {
+            std::cout << "Failed to load texture: " << path << std::endl;
+            return 0;
+        }
+        if (layer == 0) {
+            layerWidth = width;
+            layerHeight = height;
+            pixels.resize((size_t)width * height * 4 * LAYER_COUNT);
+        } else if (width != layerWidth || height != layerHeight) {
+            std::cout << "Texture " << path << " is " << width << "x" << height
+                      << ", expected " << layerWidth << "x" << layerHeight << std::endl;
+            stbi_image_free(data);
+            return 0;
+        }
+
+        size_t layerBytes = (size_t)width * height * 4;
+        std::memcpy(pixels.data() + layer * layerBytes, data, layerBytes);
+        stbi_image_free(data);
     }
 
-    GLenum format;
-    if (channels == 1)      format = GL_RED;
-    else if (channels == 3) format = GL_RGB;
-    else if (channels == 4) format = GL_RGBA;
-
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layerWidth, layerHeight, LAYER_COUNT, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    // Each layer mips on its own, so tiles no longer bleed into their neighbours.
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-    stbi_image_free(data);
     return textureID;
-}
\ No newline at end of file
+}
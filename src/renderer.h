@@ -1,20 +1,49 @@
 #pragma once
 #include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string>
+
+// Uniform locations, looked up once when the program is linked.
+struct ChunkShaderUniforms {
+    GLint tex0 = -1;
+    GLuint cameraBlock = GL_INVALID_INDEX;
+};
+
+// std140 layout of the Camera uniform block
+struct CameraUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProj;
+};
 
 class Renderer {
 public:
+    static const GLuint CAMERA_BINDING = 0;
+
     unsigned int shaderProgram;
-    GLuint atlasTexture;
+    unsigned int cutoutProgram; // same vertex shader, alpha-tested + blended fragment shader
+    GLuint blockTextures; // GL_TEXTURE_2D_ARRAY, one layer per TextureLayer
+    GLuint cameraUBO;
+    ChunkShaderUniforms uniforms;
+    ChunkShaderUniforms cutoutUniforms;
 
     Renderer();
     ~Renderer();
 
     bool initialize();
     unsigned int getShaderProgram() const { return shaderProgram; }
-    GLuint getAtlasTexture() const { return atlasTexture; }
+    GLuint getBlockTextures() const { return blockTextures; }
+
+    // Uploads the per-frame camera block, and binds program + block textures for chunk drawing.
+    void beginChunkPass(const glm::mat4& view, const glm::mat4& projection);
+
+    // Switches to the cutout program with blending on, for the leaves pass after all opaque draws.
+    void beginCutoutPass();
+    void endCutoutPass();
 
 private:
     unsigned int compileShader(unsigned int type, const char* src);
-    unsigned int createShaderProgram();
-    GLuint loadTexture(const char* path);
+    unsigned int createShaderProgram(const char* fragmentSrc);
+    GLuint loadTextureArray(const std::string& directory);
+    ChunkShaderUniforms cacheUniforms(unsigned int program);
 };
\ No newline at end of file
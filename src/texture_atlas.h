@@ -1,40 +1,21 @@
 #pragma once
-#include "block.h"
-#include <unordered_map>
-#include <string>
 
-struct AtlasConfig {
-    int columns = 1;
-    int rows = 11;
-
-    float getUScale() const { return 1.0f / columns; }
-    float getVScale() const { return 1.0f / rows; }
-};
-
-struct AtlasTexture {
-    int column;
-    int row;
-
-    AtlasTexture(int col = 0, int r = 0) : column(col), row(r) {}
-};
-
-class TextureAtlas {
-public:
-    TextureAtlas();
-
-    AtlasTexture getTexture(BlockType type, int faceIndex) const;
-
-    float getUOffset(const AtlasTexture& tex) const;
-    float getVOffset(const AtlasTexture& tex) const;
-
-    const AtlasConfig& getConfig() const { return config; }
-
-private:
-    AtlasConfig config;
-
-    std::unordered_map<BlockType, AtlasTexture[6]> blockTextures;
-
-    void initializeTextures();
+// Block textures are layers of one GL_TEXTURE_2D_ARRAY, built at startup from the
+// individual PNGs in src/textures (textureLayerFiles[i] becomes layer i). Which layer
+// each block face uses lives in the block table (block.h).
+enum TextureLayer {
+    LAYER_TUFF = 0,
+    LAYER_GRANITE,
+    LAYER_DIORITE,
+    LAYER_ANDESITE,
+    LAYER_SNOW,
+    LAYER_LEAVES,
+    LAYER_OAK_TOP,
+    LAYER_OAK_SIDE,
+    LAYER_STONE,
+    LAYER_DIRT,
+    LAYER_GRASS_TOP,
+    LAYER_COUNT
 };
 
-extern TextureAtlas g_textureAtlas;
\ No newline at end of file
+extern const char* const textureLayerFiles[LAYER_COUNT];
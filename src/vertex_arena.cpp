@@ -0,0 +1,99 @@
+#include "vertex_arena.h"
+
+static uint32_t roundUp(uint32_t count) {
+    return (count + VertexArenaAllocator::granularity - 1) / VertexArenaAllocator::granularity
+           * VertexArenaAllocator::granularity;
+}
+
+VertexArenaAllocator::VertexArenaAllocator(uint32_t capacity) {
+    grow(capacity);
+}
+
+void VertexArenaAllocator::insertFree(uint32_t offset, uint32_t size) {
+    freeByOffset[offset] = size;
+    freeBySize.insert({size, offset});
+}
+
+void VertexArenaAllocator::eraseFree(std::map<uint32_t, uint32_t>::iterator it) {
+    auto range = freeBySize.equal_range(it->second);
+    for (auto s = range.first; s != range.second; ++s) {
+        if (s->second == it->first) {
+            freeBySize.erase(s);
+            break;
+        }
+    }
+    freeByOffset.erase(it);
+}
+
+bool VertexArenaAllocator::allocate(uint32_t count, ArenaRange& out) {
+    out = ArenaRange();
+    if (count == 0) return true;
+
+    uint32_t size = roundUp(count);
+    auto best = freeBySize.lower_bound(size);
+    if (best == freeBySize.end()) return false;
+
+    uint32_t blockOffset = best->second;
+    uint32_t blockSize = best->first;
+    eraseFree(freeByOffset.find(blockOffset));
+    if (blockSize > size) insertFree(blockOffset + size, blockSize - size);
+
+    out.offset = blockOffset;
+    out.count = size;
+    usedVertices += size;
+    liveAllocations++;
+    return true;
+}
+
+void VertexArenaAllocator::free(ArenaRange& range) {
+    if (range.count == 0) return;
+
+    uint32_t offset = range.offset;
+    uint32_t size = range.count;
+    usedVertices -= size;
+    liveAllocations--;
+    range = ArenaRange();
+
+    // Coalesce with the free neighbours on both sides.
+    auto next = freeByOffset.lower_bound(offset);
+    if (next != freeByOffset.end() && offset + size == next->first) {
+        size += next->second;
+        eraseFree(next);
+    }
+    auto prev = freeByOffset.lower_bound(offset);
+    if (prev != freeByOffset.begin()) {
+        --prev;
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            eraseFree(prev);
+        }
+    }
+    insertFree(offset, size);
+}
+
+void VertexArenaAllocator::grow(uint32_t newCapacity) {
+    if (newCapacity <= totalCapacity) return;
+    ArenaRange tail;
+    tail.offset = totalCapacity;
+    tail.count = newCapacity - totalCapacity;
+    totalCapacity = newCapacity;
+
+    // Hand the new tail to free() so it merges with a free block at the old end.
+    usedVertices += tail.count;
+    liveAllocations++;
+    free(tail);
+}
+
+ArenaStats VertexArenaAllocator::stats() const {
+    ArenaStats s;
+    s.capacity = totalCapacity;
+    s.used = usedVertices;
+    s.freeBlocks = (uint32_t)freeByOffset.size();
+    s.allocations = liveAllocations;
+    for (auto& block : freeByOffset) {
+        s.freeTotal += block.second;
+        if (block.second > s.largestFree) s.largestFree = block.second;
+    }
+    return s;
+}
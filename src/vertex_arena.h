@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <map>
+
+// A sub-range of the shared chunk vertex buffer, in vertices. count == 0 means no allocation.
+struct ArenaRange {
+    uint32_t offset = 0;
+    uint32_t count = 0;
+};
+
+struct ArenaStats {
+    uint32_t capacity = 0;     // vertices
+    uint32_t used = 0;         // vertices handed out (after rounding)
+    uint32_t freeTotal = 0;
+    uint32_t freeBlocks = 0;
+    uint32_t largestFree = 0;
+    uint32_t allocations = 0;
+
+    // 0 = all free space is one block, approaching 1 = free space is scattered in small holes
+    float fragmentation() const {
+        return freeTotal ? 1.0f - (float)largestFree / (float)freeTotal : 0.0f;
+    }
+};
+
+// Best-fit free-list allocator over a linear range. Pure CPU bookkeeping: the GL
+// buffer it describes lives in the render layer (chunk_renderer.cpp), which keeps
+// this usable and testable headlessly.
+class VertexArenaAllocator {
+public:
+    static const uint32_t granularity = 64; // sizes are rounded up to this many vertices
+
+    explicit VertexArenaAllocator(uint32_t capacity = 0);
+
+    bool allocate(uint32_t count, ArenaRange& out);
+    void free(ArenaRange& range);
+    void grow(uint32_t newCapacity);
+
+    uint32_t capacity() const { return totalCapacity; }
+    ArenaStats stats() const;
+
+private:
+    void insertFree(uint32_t offset, uint32_t size);
+    void eraseFree(std::map<uint32_t, uint32_t>::iterator it);
+
+    uint32_t totalCapacity = 0;
+    uint32_t usedVertices = 0;
+    uint32_t liveAllocations = 0;
+    std::map<uint32_t, uint32_t> freeByOffset;     // offset -> size
+    std::multimap<uint32_t, uint32_t> freeBySize;  // size -> offset
+};
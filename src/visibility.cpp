@@ -0,0 +1,178 @@
+#include "visibility.h"
+#include "world.h"
+#include <cmath>
+#include <deque>
+#include <unordered_map>
+
+static const int FACE_DIR[6][3] = {
+    { 0,  0, -1},
+    { 0,  0,  1},
+    {-1,  0,  0},
+    { 1,  0,  0},
+    { 0, -1,  0},
+    { 0,  1,  0}
+};
+
+static inline int oppositeFace(int f) {
+    return f ^ 1;
+}
+
+static SectionConnectivity connectivityForSection(Chunk& chunk, int section, std::vector<int>& stack,
+                                                  std::vector<uint8_t>& visited) {
+    const int w = (int)chunk.width;
+    const int d = (int)chunk.depth;
+    const int y0 = section * Chunk::sectionHeight;
+    const int h = std::min(Chunk::sectionHeight, (int)chunk.height - y0);
+    const int cells = w * h * d;
+
+    visited.assign(cells, 0);
+    SectionConnectivity result = 0;
+    int airCells = 0;
+
+    auto cellIndex = [&](int x, int y, int z) { return x + w * (z + d * y); };
+
+    for (int y = 0; y < h; y++) {
+        for (int z = 0; z < d; z++) {
+            for (int x = 0; x < w; x++) {
+                int start = cellIndex(x, y, z);
+                if (visited[start] || blockInfo(chunk.getBlock(x, y0 + y, z).type).opaque) continue;
+
+                // Flood one see-through (non-opaque) component and record which section faces it touches.
+                uint8_t faces = 0;
+                stack.clear();
+                stack.push_back(start);
+                visited[start] = 1;
+                while (!stack.empty()) {
+                    int c = stack.back();
+                    stack.pop_back();
+                    airCells++;
+
+                    int cx = c % w;
+                    int cz = (c / w) % d;
+                    int cy = c / (w * d);
+                    if (cz == 0)     faces |= 1 << FACE_NEG_Z;
+                    if (cz == d - 1) faces |= 1 << FACE_POS_Z;
+                    if (cx == 0)     faces |= 1 << FACE_NEG_X;
+                    if (cx == w - 1) faces |= 1 << FACE_POS_X;
+                    if (cy == 0)     faces |= 1 << FACE_NEG_Y;
+                    if (cy == h - 1) faces |= 1 << FACE_POS_Y;
+
+                    for (int f = 0; f < 6; f++) {
+                        int nx = cx + FACE_DIR[f][0];
+                        int ny = cy + FACE_DIR[f][1];
+                        int nz = cz + FACE_DIR[f][2];
+                        if (nx < 0 || nx >= w || ny < 0 || ny >= h || nz < 0 || nz >= d) continue;
+                        int n = cellIndex(nx, ny, nz);
+                        if (visited[n] || blockInfo(chunk.getBlock(nx, y0 + ny, nz).type).opaque) continue;
+                        visited[n] = 1;
+                        stack.push_back(n);
+                    }
+                }
+
+                for (int a = 0; a < 6; a++) {
+                    if (!(faces & (1 << a))) continue;
+                    for (int b = 0; b < 6; b++) {
+                        if (faces & (1 << b)) result |= 1ull << (a * 6 + b);
+                    }
+                }
+            }
+        }
+    }
+
+    if (airCells == cells) return SECTION_ALL_CONNECTED;
+    return result;
+}
+
+void computeSectionConnectivity(Chunk& chunk, std::vector<SectionConnectivity>& out) {
+    std::vector<int> stack;
+    std::vector<uint8_t> visited;
+    out.resize(chunk.sectionCount());
+    for (int s = 0; s < chunk.sectionCount(); s++) {
+        out[s] = connectivityForSection(chunk, s, stack, visited);
+    }
+}
+
+bool findVisibleSections(ChunkManager& manager, const glm::vec3& cameraPos, const Frustum& frustum,
+                         std::vector<VisibleChunk>& out, std::vector<VisibleChunk>* frustumCulled) {
+    out.clear();
+    if (frustumCulled) frustumCulled->clear();
+
+    int camX = (int)std::floor(cameraPos.x + 0.5f);
+    int camY = (int)std::floor(cameraPos.y + 0.5f);
+    int camZ = (int)std::floor(cameraPos.z + 0.5f);
+    int startCX = getChunkCoord((float)camX);
+    int startCZ = getChunkCoord((float)camZ);
+
+    ManagedChunk* startChunk = manager.getChunk(startCX, startCZ);
+    if (!startChunk) return false;
+    const Chunk& sc = startChunk->chunk;
+    if (camY < 0 || camY >= (int)sc.height) return false;
+    const int sections = sc.sectionCount();
+
+    struct Node {
+        ManagedChunk* chunk;
+        int cx, sy, cz;
+        int enteredFrom;  // face of this section we came in through, -1 for the start
+        uint8_t dirsTaken; // faces we have stepped out of so far along this path
+    };
+
+    std::unordered_map<ManagedChunk*, size_t> outIndex;
+    std::unordered_map<ManagedChunk*, size_t> culledIndex;
+    std::unordered_map<ManagedChunk*, uint32_t> visited;
+    std::deque<Node> queue;
+
+    auto markSection = [](std::vector<VisibleChunk>& list, std::unordered_map<ManagedChunk*, size_t>& index,
+                          ManagedChunk* mc, int sy) {
+        auto it = index.find(mc);
+        if (it == index.end()) {
+            it = index.emplace(mc, list.size()).first;
+            list.push_back({mc, 0u});
+        }
+        list[it->second].sectionMask |= 1u << sy;
+    };
+    auto markVisible = [&](ManagedChunk* mc, int sy) { markSection(out, outIndex, mc, sy); };
+
+    int startSY = camY / Chunk::sectionHeight;
+    queue.push_back({startChunk, startCX, startSY, startCZ, -1, 0});
+    visited[startChunk] |= 1u << startSY;
+    markVisible(startChunk, startSY);
+
+    while (!queue.empty()) {
+        Node node = queue.front();
+        queue.pop_front();
+
+        const std::vector<SectionConnectivity>& conn = node.chunk->mesh.sectionConnectivity;
+        // Not meshed yet: nothing to draw, but do not let it hide what is behind it.
+        SectionConnectivity c = ((int)conn.size() > node.sy) ? conn[node.sy] : SECTION_ALL_CONNECTED;
+
+        for (int f = 0; f < 6; f++) {
+            // Never go back against a direction we already moved in.
+            if (node.dirsTaken & (1 << oppositeFace(f))) continue;
+            if (node.enteredFrom >= 0 && !facesConnected(c, node.enteredFrom, f)) continue;
+
+            int ncx = node.cx + FACE_DIR[f][0];
+            int nsy = node.sy + FACE_DIR[f][1];
+            int ncz = node.cz + FACE_DIR[f][2];
+            if (nsy < 0 || nsy >= sections) continue;
+
+            ManagedChunk* next = (ncx == node.cx && ncz == node.cz) ? node.chunk : manager.getChunk(ncx, ncz);
+            if (!next) continue;
+
+            uint32_t& seen = visited[next];
+            if (seen & (1u << nsy)) continue;
+
+            const Chunk& nc = next->chunk;
+            glm::vec3 min(ncx * (float)nc.width - 0.5f, nsy * (float)Chunk::sectionHeight - 0.5f, ncz * (float)nc.depth - 0.5f);
+            glm::vec3 max = min + glm::vec3((float)nc.width, (float)Chunk::sectionHeight, (float)nc.depth);
+            if (!frustum.intersectsBox(min, max)) {
+                if (frustumCulled) markSection(*frustumCulled, culledIndex, next, nsy);
+                continue;
+            }
+
+            seen |= 1u << nsy;
+            markVisible(next, nsy);
+            queue.push_back({next, ncx, nsy, ncz, oppositeFace(f), (uint8_t)(node.dirsTaken | (1 << f))});
+        }
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "chunk.h"
+#include "frustum.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct ChunkManager;
+
+// Section faces, same order as cubeFaces: FRONT(-Z), BACK(+Z), LEFT(-X), RIGHT(+X), BOTTOM(-Y), TOP(+Y)
+enum SectionFace {
+    FACE_NEG_Z = 0,
+    FACE_POS_Z,
+    FACE_NEG_X,
+    FACE_POS_X,
+    FACE_NEG_Y,
+    FACE_POS_Y
+};
+
+// Bit (a * 6 + b) is set when faces a and b of a section can see each other through air
+// or other non-opaque blocks.
+typedef uint64_t SectionConnectivity;
+
+const SectionConnectivity SECTION_ALL_CONNECTED = (1ull << 36) - 1;
+
+inline bool facesConnected(SectionConnectivity c, int a, int b) {
+    return (c >> (a * 6 + b)) & 1ull;
+}
+
+// Flood-fills the non-opaque blocks (air, leaves) in every section of the chunk (computed at mesh time).
+void computeSectionConnectivity(Chunk& chunk, std::vector<SectionConnectivity>& out);
+
+struct VisibleChunk {
+    ManagedChunk* chunk;
+    uint32_t sectionMask; // bit s set = section s reachable and inside the frustum
+};
+
+// BFS over sections starting at the camera's section, only crossing faces that are
+// connected through air and never stepping back against a direction already taken.
+// Returns false (and leaves out empty) when the camera is outside the loaded column range.
+// frustumCulled, if given, gets the sections the search reached but rejected on the frustum test
+// (sectionMask = those sections), so they can be told apart from occluded ones.
+bool findVisibleSections(ChunkManager& manager, const glm::vec3& cameraPos, const Frustum& frustum,
+                         std::vector<VisibleChunk>& out, std::vector<VisibleChunk>* frustumCulled = nullptr);
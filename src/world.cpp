@@ -1,7 +1,15 @@
 #include "world.h"
+#include "visibility.h"
+#include "lod.h"
+#include "region_storage.h"
+#include "edit_journal.h"
+#include "chunk_cache.h"
+#include "profiler.h"
 #include <cmath>
 #include <cstdlib>
+#include <memory>
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <thread>
 #include <queue>
@@ -9,6 +17,8 @@
 #include <condition_variable>
 #include <atomic>
 #include <functional>
+#include <string>
+#include <chrono>
 #include <cmath>
 // Async
 class ThreadPool {
@@ -16,7 +26,10 @@ public:
     explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency()) {
         if (threadCount == 0) threadCount = 1;
         for (size_t i = 0; i < threadCount; ++i) {
-            workers.emplace_back([this]{ this->workerLoop(); });
+            workers.emplace_back([this, i]{
+                PROFILE_THREAD("Worker " + std::to_string(i));
+                this->workerLoop();
+            });
         }
     }
     ~ThreadPool() {
@@ -31,6 +44,12 @@ public:
         }
         cv.notify_one();
     }
+    size_t queued() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return jobs.size();
+    }
+    size_t threadCount() const { return workers.size(); }
+    uint64_t busyNanoseconds() const { return busyNs.load(std::memory_order_relaxed); }
 private:
     void workerLoop() {
         while (!stop.load()) {
@@ -42,7 +61,11 @@ private:
                 job = std::move(jobs.front());
                 jobs.pop();
             }
-            if (job) job();
+            if (!job) continue;
+            auto start = std::chrono::steady_clock::now();
+            job();
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            busyNs.fetch_add((uint64_t)ns.count(), std::memory_order_relaxed);
         }
     }
     std::vector<std::thread> workers;
@@ -50,10 +73,16 @@ private:
     std::mutex mtx;
     std::condition_variable cv;
     std::atomic<bool> stop{false};
+    std::atomic<uint64_t> busyNs{0};
 };
 
+static size_t completedMeshBytes(const CompletedMesh& m) {
+    return (m.vertices.capacity() + m.cutoutVertices.capacity()) * sizeof(float);
+}
+
 void CompletedMeshQueue::push(CompletedMesh m) {
     std::lock_guard<std::mutex> lock(mtx);
+    vertexBytes += completedMeshBytes(m);
     q.push(std::move(m));
 }
 
@@ -62,12 +91,24 @@ bool CompletedMeshQueue::try_pop(CompletedMesh& out) {
     if (q.empty()) return false;
     out = std::move(q.front());
     q.pop();
+    vertexBytes -= completedMeshBytes(out);
     return true;
 }
 
+size_t CompletedMeshQueue::size() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return q.size();
+}
+
+size_t CompletedMeshQueue::bytes() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return vertexBytes;
+}
+
 struct CompletedTerrain {
     int cx;
     int cz;
+    bool restored; // from the chunk cache or a region file, already has its structures
 };
 
 class CompletedTerrainQueue {
@@ -100,7 +141,65 @@ ThreadPool& getThreadPool() {
     return *g_pool;
 }
 
+size_t queuedJobs() {
+    return getThreadPool().queued();
+}
+
+WorkerPoolStats getWorkerPoolStats() {
+    ThreadPool& pool = getThreadPool();
+    WorkerPoolStats s;
+    s.workers = pool.threadCount();
+    s.queuedJobs = pool.queued();
+    s.busyNs = pool.busyNanoseconds();
+    return s;
+}
+
+ChunkStateCounts countChunkStates(ChunkManager& manager) {
+    ChunkStateCounts c;
+    for (auto& pair : manager.chunks) {
+        const ManagedChunk* mc = pair.second;
+        c.loaded++;
+        c.terrainGenerated += mc->terrainGenerated;
+        c.structuresGenerated += mc->structuresGenerated;
+        c.meshUploaded += mc->meshUploaded;
+        c.meshDirty += mc->meshDirty;
+        c.inTerrainQueue += mc->inTerrainQueue;
+        c.inMeshQueue += mc->inMeshQueue;
+        c.vertices += mc->mesh.vertexCount + mc->mesh.cutoutVertexCount;
+    }
+    return c;
+}
+
 CompletedMeshQueue g_completedMeshes;
+VertexBufferPool g_vertexBuffers;
+
+std::vector<float> VertexBufferPool::acquire() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (spare.empty()) return std::vector<float>();
+    std::vector<float> buffer = std::move(spare.back());
+    spare.pop_back();
+    return buffer;
+}
+
+size_t VertexBufferPool::spareBytes() {
+    std::lock_guard<std::mutex> lock(mtx);
+    size_t bytes = 0;
+    for (auto& buffer : spare) bytes += buffer.capacity() * sizeof(float);
+    return bytes;
+}
+
+void VertexBufferPool::trim() {
+    std::lock_guard<std::mutex> lock(mtx);
+    spare.clear();
+    spare.shrink_to_fit();
+}
+
+void VertexBufferPool::release(std::vector<float>&& buffer) {
+    if (buffer.capacity() == 0) return;
+    buffer.clear();
+    std::lock_guard<std::mutex> lock(mtx);
+    if (spare.size() < MAX_SPARE) spare.push_back(std::move(buffer));
+}
 
 int perm[512];
 
@@ -306,12 +405,63 @@ void ChunkManager::addChunk(int cx, int cz, ManagedChunk* chunk) {
 }
 
 void ChunkManager::removeChunk(int cx, int cz) {
-    auto key = std::make_pair(cx, cz);
-    auto it = chunks.find(key);
-    if (it != chunks.end()) {
-        delete it->second;
-        chunks.erase(it);
+    if (ManagedChunk* mc = detachChunk(cx, cz)) pool.release(mc);
+}
+
+ManagedChunk* ChunkManager::detachChunk(int cx, int cz) {
+    auto it = chunks.find({cx, cz});
+    if (it == chunks.end()) return nullptr;
+    ManagedChunk* mc = it->second;
+    if (onRemove) onRemove(mc);
+    chunks.erase(it);
+    return mc;
+}
+
+ChunkPool::~ChunkPool() {
+    for (ManagedChunk* mc : idle) delete mc;
+}
+
+ManagedChunk* ChunkPool::acquire(int cx, int cz) {
+    ManagedChunk* mc = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!idle.empty()) {
+            mc = idle.back();
+            idle.pop_back();
+            counters.reuses++;
+        } else {
+            counters.allocations++;
+        }
     }
+    if (!mc) return new ManagedChunk(cx, cz);
+    mc->reset(cx, cz);
+    return mc;
+}
+
+void ChunkPool::release(ManagedChunk* mc) {
+    std::lock_guard<std::mutex> lock(mtx);
+    idle.push_back(mc);
+    trimLocked();
+}
+
+void ChunkPool::setCapacity(size_t idleChunks) {
+    std::lock_guard<std::mutex> lock(mtx);
+    capacity = idleChunks;
+    trimLocked();
+}
+
+void ChunkPool::trimLocked() {
+    while (idle.size() > capacity) {
+        delete idle.back();
+        idle.pop_back();
+    }
+}
+
+ChunkPoolStats ChunkPool::stats() {
+    std::lock_guard<std::mutex> lock(mtx);
+    ChunkPoolStats s = counters;
+    s.idle = idle.size();
+    return s;
 }
 
 std::vector<ManagedChunk*> ChunkManager::getNeighbors4(int cx, int cz) {
@@ -349,125 +499,103 @@ void setBlockWorld(ChunkManager* manager, int worldX, int y, int worldZ, BlockTy
     if (modified) modified->insert({cx, cz});
 }
 
-void generateTerrainForChunk(Chunk& chunk) {
-    for (int x = 0; x < (int)chunk.width; x++) {
-        for (int z = 0; z < (int)chunk.depth; z++) {
-            int worldX = chunk.chunkX * chunk.width + x;
-            int worldZ = chunk.chunkZ * chunk.depth + z;
+TerrainColumn sampleTerrainColumn(int worldX, int worldZ, int maxHeight) {
+    const float baseHeight = 48.0f;
 
-            const float baseHeight = 48.0f;
-
-            const float macroScale = 0.0012f;
-            const float macroAmp   = 20.0f;
-            float macroN = perlin(worldX * macroScale, worldZ * macroScale);
-            float macroOffset = macroN * macroAmp;
-
-            const float regionScale = 0.0035f;
-            const float regionAmp   = 6.0f;
-            float regionN = perlin(worldX * regionScale + 37.0f, worldZ * regionScale - 91.0f);
-            float regionOffset = regionN * regionAmp;
-
-            const float maskScale = 0.010f;
-            float maskRaw = perlin(worldX * maskScale + 200.0f, worldZ * maskScale + 200.0f);
-            float mask01 = (maskRaw + 1.0f) * 0.5f;
-
-            const float maskThreshold = 0.62f;
-            const float maskFeather   = 0.08f;
-            float hillMask = smoothstepf(maskThreshold, maskThreshold + maskFeather, mask01);
-
-            const float detailScale = 0.05f;
-            const float detailAmp   = 2.0f;
-            float detailN = perlin(worldX * detailScale - 120.0f, worldZ * detailScale + 53.0f);
-            float detailOffset = detailN * detailAmp;
-
-            //const float mountScale = 0.015f;
-            //const float mountAmp   = 32.0f;
-            //const float mountMask = 0.75f;
-            //float mountN = perlin(worldX * mountScale - 120.0f, worldZ * mountScale + 53.0f);
-            //float mountOffset = pow(((mountN - mountMask)/mountMask),0.9) * mountAmp;
-            //float mountOffset = ((mountN - mountMask)/(1.0f - mountMask)) * mountAmp;
-            //if (mountN < mountMask) {
-            //    mountOffset = 0.0f;
-            //}
-            float mountOffset = getMountOffset(worldX, worldZ);
-
-            const float hillScale = 0.07f;
-            const float hillAmp   = 14.0f;
-            float hillN = perlin(worldX * hillScale + 777.0f, worldZ * hillScale - 333.0f);
-            float hillOnlyUp = ((hillN + 1.0f) * 0.5f) * hillAmp;
-            float hillOffset = hillOnlyUp * hillMask;
-
-            //int terrainHeight = int(baseHeight + macroOffset + regionOffset + detailOffset + hillOffset);
-            int terrainHeight = int(baseHeight + macroOffset + regionOffset + detailOffset + hillOffset + mountOffset);
-            //int terrainHeight = int(baseHeight + macroOffset + mountOffset + regionOffset + hillOffset);
-            //int terrainHeight = int(mountOffset);
-
-            if (terrainHeight >= (int)chunk.height) terrainHeight = chunk.height - 1;
-
-            float localVariationMag = std::fabs(detailOffset) + hillMask * 0.5f * hillAmp;
-            int minDirt = 2;
-            int maxDirt = 5;
-            int dirtDepth = minDirt + int(clampf(localVariationMag / (hillAmp + detailAmp), 0.0f, 1.0f) * (maxDirt - minDirt));
-
-            int stoneThreshold = int(baseHeight + macroOffset + regionAmp * 0.8f);
-            if (terrainHeight > stoneThreshold) {
-                dirtDepth = std::max(dirtDepth - (terrainHeight - stoneThreshold) / 2, 1);
-            }
+    const float macroScale = 0.0012f;
+    const float macroAmp   = 20.0f;
+    float macroN = perlin(worldX * macroScale, worldZ * macroScale);
+    float macroOffset = macroN * macroAmp;
 
-            if (dirtDepth > terrainHeight) dirtDepth = terrainHeight;
+    const float regionScale = 0.0035f;
+    const float regionAmp   = 6.0f;
+    float regionN = perlin(worldX * regionScale + 37.0f, worldZ * regionScale - 91.0f);
+    float regionOffset = regionN * regionAmp;
 
-            uint32_t blockSeed = 1234567;
+    const float maskScale = 0.010f;
+    float maskRaw = perlin(worldX * maskScale + 200.0f, worldZ * maskScale + 200.0f);
+    float mask01 = (maskRaw + 1.0f) * 0.5f;
 
-            NoiseOffset graniteOffset = makeNoiseOffset(blockSeed + 10);
-            NoiseOffset dioriteOffset = makeNoiseOffset(blockSeed + 20);
-            NoiseOffset andesiteOffset = makeNoiseOffset(blockSeed + 30);
-            NoiseOffset tuffOffset    = makeNoiseOffset(blockSeed + 40);
+    const float maskThreshold = 0.62f;
+    const float maskFeather   = 0.08f;
+    float hillMask = smoothstepf(maskThreshold, maskThreshold + maskFeather, mask01);
 
-            for (int y = 0; y < (int)chunk.height; y++) {
-                if (y > terrainHeight)
-                    chunk.setBlock(x, y, z, AIR);
+    const float detailScale = 0.05f;
+    const float detailAmp   = 2.0f;
+    float detailN = perlin(worldX * detailScale - 120.0f, worldZ * detailScale + 53.0f);
+    float detailOffset = detailN * detailAmp;
 
-                else if (mountOffset > 0.0f) {
-                    if (y == terrainHeight)
-                        chunk.setBlock(x, y, z, DIRT);
+    float mountOffset = getMountOffset(worldX, worldZ);
 
-                    else if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, graniteOffset))
-                        chunk.setBlock(x, y, z, GRANITE);
+    const float hillScale = 0.07f;
+    const float hillAmp   = 14.0f;
+    float hillN = perlin(worldX * hillScale + 777.0f, worldZ * hillScale - 333.0f);
+    float hillOnlyUp = ((hillN + 1.0f) * 0.5f) * hillAmp;
+    float hillOffset = hillOnlyUp * hillMask;
 
-                    else if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, andesiteOffset))
-                        chunk.setBlock(x, y, z, ANDESITE);
+    int terrainHeight = int(baseHeight + macroOffset + regionOffset + detailOffset + hillOffset + mountOffset);
 
-                    else if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, tuffOffset))
-                        chunk.setBlock(x, y, z, TUFF);
+    if (terrainHeight > maxHeight) terrainHeight = maxHeight;
 
-                    else if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, dioriteOffset))
-                        chunk.setBlock(x, y, z, DIORITE);
+    float localVariationMag = std::fabs(detailOffset) + hillMask * 0.5f * hillAmp;
+    int minDirt = 2;
+    int maxDirt = 5;
+    int dirtDepth = minDirt + int(clampf(localVariationMag / (hillAmp + detailAmp), 0.0f, 1.0f) * (maxDirt - minDirt));
 
-                    else
-                        chunk.setBlock(x, y, z, STONE);
-                }
+    int stoneThreshold = int(baseHeight + macroOffset + regionAmp * 0.8f);
+    if (terrainHeight > stoneThreshold) {
+        dirtDepth = std::max(dirtDepth - (terrainHeight - stoneThreshold) / 2, 1);
+    }
 
-                else if (y == terrainHeight)
-                    chunk.setBlock(x, y, z, GRASS);
+    if (dirtDepth > terrainHeight) dirtDepth = terrainHeight;
 
-                else if (y >= terrainHeight - dirtDepth)
-                    chunk.setBlock(x, y, z, DIRT);
+    return { terrainHeight, dirtDepth, mountOffset };
+}
 
-                else if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, graniteOffset))
-                    chunk.setBlock(x, y, z, GRANITE);
+static const uint32_t blockSeed = 1234567;
+static const NoiseOffset graniteOffset  = makeNoiseOffset(blockSeed + 10);
+static const NoiseOffset dioriteOffset  = makeNoiseOffset(blockSeed + 20);
+static const NoiseOffset andesiteOffset = makeNoiseOffset(blockSeed + 30);
+static const NoiseOffset tuffOffset     = makeNoiseOffset(blockSeed + 40);
+
+// The only per-block work left in terrain generation: 3D ore/stone-variant noise.
+static BlockType stoneAt(int worldX, int y, int worldZ) {
+    if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, graniteOffset))  return GRANITE;
+    if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, andesiteOffset)) return ANDESITE;
+    if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, tuffOffset))     return TUFF;
+    if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, dioriteOffset))  return DIORITE;
+    return STONE;
+}
 
-                else if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, andesiteOffset))
-                    chunk.setBlock(x, y, z, ANDESITE);
+void generateTerrainForChunk(Chunk& chunk) {
+    const int height = (int)chunk.height;
 
-                else if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, tuffOffset))
-                    chunk.setBlock(x, y, z, TUFF);
+    for (int z = 0; z < (int)chunk.depth; z++) {
+        for (int x = 0; x < (int)chunk.width; x++) {
+            int worldX = chunk.chunkX * chunk.width + x;
+            int worldZ = chunk.chunkZ * chunk.depth + z;
 
-                else if (blockNoise(worldX, y, worldZ, 0.05f, 0.4f, dioriteOffset))
-                    chunk.setBlock(x, y, z, DIORITE);
-                
-                else
-                    chunk.setBlock(x, y, z, STONE);
-        }
+            TerrainColumn col = sampleTerrainColumn(worldX, worldZ, height - 1);
+            int top = col.terrainHeight;
+
+            // Runs: air above the surface, surface block, dirt band, then stone body.
+            chunk.fillColumn(x, z, top + 1, height, AIR);
+
+            int stoneTop;
+            if (col.mountOffset > 0.0f) {
+                chunk.fillColumn(x, z, top, top + 1, DIRT);
+                stoneTop = top;
+            } else {
+                chunk.fillColumn(x, z, top, top + 1, GRASS);
+                stoneTop = top - col.dirtDepth;
+                chunk.fillColumn(x, z, stoneTop, top, DIRT);
+            }
+
+            Block* column = chunk.column(x, z);
+            for (int y = 0; y < std::min(stoneTop, height); y++) {
+                column[y].type = stoneAt(worldX, y, worldZ);
+                column[y].axis = LogAxis::Y;
+            }
         }
     }
 }
@@ -576,6 +704,7 @@ void generateTrees(Chunk& chunk, ChunkManager* manager) {
 }
 
 void updateChunks(ChunkManager& manager, glm::vec3 pos, int radius, unsigned int shader) {
+    PROFILE_SCOPE("updateChunks");
     while (true) {
         CompletedTerrain t;
         if (!g_completedTerrain.try_pop(t)) break;
@@ -583,6 +712,10 @@ void updateChunks(ChunkManager& manager, glm::vec3 pos, int radius, unsigned int
         if (mc) {
             mc->inTerrainQueue = false;
             mc->terrainGenerated = true;
+            if (t.restored) {
+                mc->structuresGenerated = true;
+                applyReplayedEdits(manager, mc);
+            }
             mc->meshDirty = true;
         }
     }
@@ -611,15 +744,35 @@ void updateChunks(ChunkManager& manager, glm::vec3 pos, int radius, unsigned int
         }
     }
     for (auto& key : toRemove) {
-        manager.removeChunk(key.first, key.second);
+        ManagedChunk* mc = manager.getChunk(key.first, key.second);
+        if (mc->edited) g_regionStorage.saveChunkAsync(mc->chunk);
+        if (mc->terrainGenerated && mc->structuresGenerated) {
+            // Compressed on a worker, which then hands the chunk back to the pool. The ticket
+            // is taken here so a reload of this position can cancel the store.
+            manager.detachChunk(key.first, key.second);
+            ChunkPool* pool = &manager.pool;
+            uint64_t ticket = g_chunkCache.beginStore(key.first, key.second);
+            getThreadPool().enqueue([mc, pool, ticket]() {
+                PROFILE_SCOPE("Cache chunk");
+                g_chunkCache.store(mc->chunk, ticket);
+                pool->release(mc);
+            });
+        } else {
+            manager.removeChunk(key.first, key.second);
+        }
     }
 
+    // Enough idle chunks to replace a full ring of the load square (moving diagonally across a
+    // chunk border swaps a row and a column); shrinking the radius frees the surplus.
+    int side = 2 * fullRadius + 1;
+    manager.pool.setCapacity(4 * side);
+
     std::vector<std::pair<int,int>> newlyCreated;
     for (auto& p : shouldExist) {
         int cx = p.first;
         int cz = p.second;
         if (!manager.getChunk(cx, cz)) {
-            ManagedChunk* mc = new ManagedChunk(cx, cz);
+            ManagedChunk* mc = manager.pool.acquire(cx, cz);
             manager.addChunk(cx, cz, mc);
             newlyCreated.emplace_back(cx, cz);
         }
@@ -634,8 +787,15 @@ void updateChunks(ChunkManager& manager, glm::vec3 pos, int radius, unsigned int
             int cz = mc->chunk.chunkZ;
 
             getThreadPool().enqueue([mc, cx, cz]() {
-                generateTerrainForChunk(mc->chunk);
-                g_completedTerrain.push({cx, cz});
+                PROFILE_SCOPE("Terrain job");
+                // Recently unloaded chunks come back from the cache, saved ones from disk,
+                // everything else is generated.
+                bool restored = g_chunkCache.take(mc->chunk) || g_regionStorage.loadChunk(mc->chunk);
+                if (!restored) {
+                    PROFILE_SCOPE("Generate terrain");
+                    generateTerrainForChunk(mc->chunk);
+                }
+                g_completedTerrain.push({cx, cz, restored});
             });
         }
     }
@@ -643,9 +803,11 @@ void updateChunks(ChunkManager& manager, glm::vec3 pos, int radius, unsigned int
     for (auto& pair : manager.chunks) {
         ManagedChunk* mc = pair.second;
         if (mc->terrainGenerated && !mc->structuresGenerated && !mc->inStructQueue) {
+            PROFILE_SCOPE("Generate trees");
             generateTrees(mc->chunk, &manager);
             mc->structuresGenerated = true;
             mc->meshDirty = true;
+            applyReplayedEdits(manager, mc);
         }
     }
 
@@ -657,16 +819,51 @@ void updateChunks(ChunkManager& manager, glm::vec3 pos, int radius, unsigned int
         if (!mc->terrainGenerated) continue;
         if (!mc->structuresGenerated) continue;
 
+        int cx = p.first;
+        int cz = p.second;
+        int scale = lodScaleForChunk(cx, cz, camChunkX, camChunkZ);
+        int neighborScales[4] = {
+            lodScaleForChunk(cx, cz - 1, camChunkX, camChunkZ),
+            lodScaleForChunk(cx, cz + 1, camChunkX, camChunkZ),
+            lodScaleForChunk(cx - 1, cz, camChunkX, camChunkZ),
+            lodScaleForChunk(cx + 1, cz, camChunkX, camChunkZ)
+        };
+        if (scale != mc->meshScale ||
+            !std::equal(neighborScales, neighborScales + 4, mc->meshNeighborScales)) {
+            mc->meshDirty = true;
+        }
+
         if ((!mc->meshUploaded || mc->meshDirty) && !mc->inMeshQueue) {
             mc->inMeshQueue = true;
-            int cx = p.first;
-            int cz = p.second;
-            getThreadPool().enqueue([cx, cz, &manager]() {
-                auto m = manager.getChunk(cx, cz);
-                if (!m) return;
-                auto verts = ChunkMesh::buildVertices(m->chunk, &manager);
-                g_completedMeshes.push({cx, cz, std::move(verts)});
+            mc->meshScale = scale;
+            std::copy(neighborScales, neighborScales + 4, mc->meshNeighborScales);
+            std::array<int, 4> seams = { neighborScales[0], neighborScales[1], neighborScales[2], neighborScales[3] };
+            // The job only touches its own chunk, which is not unloaded while inMeshQueue is set;
+            // neighbours can be unloaded and pooled at any time, so their edges are copied here.
+            ChunkBorders borders;
+            borders.copyFrom(manager, cx, cz, scale, neighborScales);
+            getThreadPool().enqueue([mc, cx, cz, scale, seams, borders = std::move(borders)]() {
+                PROFILE_SCOPE("Mesh job");
+                CompletedMesh done;
+                done.cx = cx;
+                done.cz = cz;
+                done.cutoutVertices = g_vertexBuffers.acquire();
+                if (scale > 1) {
+                    Chunk lodChunk;
+                    downsampleChunk(mc->chunk, scale, lodChunk);
+                    done.vertices = ChunkMesh::buildVertices(lodChunk, borders, &done.sectionStarts, seams.data(),
+                                                             &done.cutoutVertices, &done.cutoutSectionStarts,
+                                                             g_vertexBuffers.acquire());
+                } else {
+                    done.vertices = ChunkMesh::buildVertices(mc->chunk, borders, &done.sectionStarts, seams.data(),
+                                                             &done.cutoutVertices, &done.cutoutSectionStarts,
+                                                             g_vertexBuffers.acquire());
+                }
+                // Occlusion still works on the full-resolution blocks.
+                PROFILE_SCOPE("Section connectivity");
+                computeSectionConnectivity(mc->chunk, done.sectionConnectivity);
+                g_completedMeshes.push(std::move(done));
             });
         }
     }
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #include <vector>
 #include <queue>
 #include <mutex>
+#include <functional>
 #include <glm/glm.hpp>
 
 struct pair_hash {
@@ -22,12 +23,47 @@ enum BiomeType {
     MOUNTAIN
 };
 
+struct ChunkPoolStats {
+    size_t allocations = 0; // chunks created with new
+    size_t reuses = 0;
+    size_t idle = 0;
+};
+
+// Free list of unloaded chunks. A released chunk keeps its block array and mesh vectors, so a
+// chunk streamed in as another streams out reuses them instead of going back to the system
+// allocator. Up to capacity idle chunks are kept; the rest are deleted. Thread-safe, as chunks
+// can be released from worker jobs.
+class ChunkPool {
+public:
+    ~ChunkPool();
+
+    ManagedChunk* acquire(int cx, int cz);
+    void release(ManagedChunk* mc);
+    void setCapacity(size_t idleChunks);
+    ChunkPoolStats stats();
+
+private:
+    std::mutex mtx;
+    std::vector<ManagedChunk*> idle;
+    size_t capacity = 0;
+    ChunkPoolStats counters;
+
+    void trimLocked();
+};
+
 struct ChunkManager {
     std::unordered_map<std::pair<int,int>, ManagedChunk*, pair_hash> chunks;
+    ChunkPool pool;
+
+    // Called just before a chunk is removed, e.g. so the renderer can free its GPU range.
+    std::function<void(ManagedChunk*)> onRemove;
 
     ManagedChunk* getChunk(int cx, int cz);
     void addChunk(int cx, int cz, ManagedChunk* chunk);
+    // Removes the chunk and returns it to the pool.
     void removeChunk(int cx, int cz);
+    // Removes the chunk without releasing it; the caller hands it to pool.release() when done.
+    ManagedChunk* detachChunk(int cx, int cz);
     std::vector<ManagedChunk*> getNeighbors4(int cx, int cz);
 
     ~ChunkManager();
@@ -37,25 +73,83 @@ struct CompletedMesh {
     int cx;
     int cz;
     std::vector<float> vertices;
+    std::vector<int> sectionStarts;
+    std::vector<uint64_t> sectionConnectivity;
+    std::vector<float> cutoutVertices;
+    std::vector<int> cutoutSectionStarts;
 };
 class CompletedMeshQueue {
 public:
     void push(CompletedMesh m);
     bool try_pop(CompletedMesh& out);
+    size_t size();
+    size_t bytes(); // vertex storage waiting for upload
 private:
     std::mutex mtx;
     std::queue<CompletedMesh> q;
+    size_t vertexBytes = 0;
 };
 class ThreadPool;
 ThreadPool& getThreadPool();
+size_t queuedJobs(); // jobs waiting for a worker
+
+struct WorkerPoolStats {
+    size_t workers = 0;
+    size_t queuedJobs = 0;
+    uint64_t busyNs = 0; // time spent running jobs since startup, summed over the workers
+};
+WorkerPoolStats getWorkerPoolStats();
 extern CompletedMeshQueue g_completedMeshes;
 
+// Spare vertex vectors: mesh jobs build into one that still has the capacity of an earlier
+// mesh, and the render thread hands it back once the vertices are uploaded, so remeshing
+// doesn't reallocate vertex storage.
+class VertexBufferPool {
+public:
+    std::vector<float> acquire();
+    void release(std::vector<float>&& buffer);
+    size_t spareBytes();
+    void trim(); // frees every spare buffer
+
+private:
+    static const size_t MAX_SPARE = 64;
+    std::mutex mtx;
+    std::vector<std::vector<float>> spare;
+};
+
+extern VertexBufferPool g_vertexBuffers;
+
+// Surface parameters for one (x, z) column of generated terrain
+struct TerrainColumn {
+    int terrainHeight;
+    int dirtDepth;
+    float mountOffset;
+};
+
+// Loaded chunks by streaming state, for the performance overlay
+struct ChunkStateCounts {
+    int loaded = 0;
+    int terrainGenerated = 0;
+    int structuresGenerated = 0;
+    int meshUploaded = 0;
+    int meshDirty = 0;
+    int inTerrainQueue = 0;
+    int inMeshQueue = 0;
+    uint64_t vertices = 0; // uploaded, opaque and cutout
+};
+ChunkStateCounts countChunkStates(ChunkManager& manager);
+
 // Terrain generation
 void initPerlin(unsigned int seed = 0);
 float perlin(float x, float y);
 float getTerrainHeight(int worldX, int worldZ);
 BiomeType getBiome(int worldX, int worldZ);
+TerrainColumn sampleTerrainColumn(int worldX, int worldZ, int maxHeight);
 void generateTerrainForChunk(Chunk& chunk);
+// Saved edit deltas are only valid against the terrain they were diffed with, so this goes into
+// their header. Bump it whenever generateTerrainForChunk's output changes (that is, whenever
+// bench/goldens.txt has to be rewritten).
+const uint32_t TERRAIN_GENERATOR_VERSION = 1;
 void generateTrees(Chunk& chunk, ChunkManager* manager);
 
 // World utilities
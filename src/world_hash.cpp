@@ -0,0 +1,53 @@
+#include "world_hash.h"
+#include <cstring>
+
+static const uint64_t FNV_OFFSET = 1469598103934665603ull;
+static const uint64_t FNV_PRIME  = 1099511628211ull;
+
+static inline uint64_t fnv1a(uint64_t h, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        h ^= (v >> (i * 8)) & 0xFF;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+// splitmix64 finalizer, spreads per-triangle hashes before they are summed
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t hashChunkBlocks(Chunk& chunk) {
+    uint64_t h = FNV_OFFSET;
+    for (int x = 0; x < (int)chunk.width; x++) {
+        for (int y = 0; y < (int)chunk.height; y++) {
+            for (int z = 0; z < (int)chunk.depth; z++) {
+                const Block& b = chunk.getBlock(x, y, z);
+                h = fnv1a(h, (uint32_t)b.type | ((uint32_t)b.axis << 16));
+            }
+        }
+    }
+    return h;
+}
+
+uint64_t hashMeshVertices(const std::vector<float>& vertices, int floatsPerVertex) {
+    const size_t triFloats = 3 * (size_t)floatsPerVertex;
+    const size_t triCount = vertices.size() / triFloats;
+
+    uint64_t sum = 0;
+    for (size_t t = 0; t < triCount; t++) {
+        uint64_t h = FNV_OFFSET;
+        for (size_t i = 0; i < triFloats; i++) {
+            uint32_t bits;
+            std::memcpy(&bits, &vertices[t * triFloats + i], sizeof(bits));
+            h = fnv1a(h, bits);
+        }
+        sum += mix64(h);
+    }
+    return mix64(sum ^ (uint64_t)triCount);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "chunk.h"
+#include <cstdint>
+#include <vector>
+
+// Stable content hashes used to check that generation and meshing output is unchanged.
+
+// Hashes block type/axis in x, y, z order, independent of the storage layout.
+uint64_t hashChunkBlocks(Chunk& chunk);
+
+// Order-independent hash of a triangle list: the same set of triangles hashes the same
+// no matter in which order the mesher emits them.
+uint64_t hashMeshVertices(const std::vector<float>& vertices, int floatsPerVertex);